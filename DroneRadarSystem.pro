@@ -11,6 +11,11 @@ DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060900
 DEFINES += QT_NO_DEPRECATED_WARNINGS
 DEFINES += QT_DEPRECATED_WARNINGS_SINCE=0x000000
 DEFINES += NDEBUG
+
+# 性能追踪：qmake CONFIG+=radar_tracing 启用，未启用时追踪宏编译为空语句
+radar_tracing {
+    DEFINES += RADAR_ENABLE_TRACING
+}
 QMAKE_CXXFLAGS += -Wno-deprecated-declarations
 QMAKE_CXXFLAGS += -Wno-error=deprecated-declarations
 QMAKE_CXXFLAGS += -fpermissive
@@ -27,8 +32,28 @@ SOURCES += \
     src/Drone.cpp \
     src/DroneManager.cpp \
     src/RadarSimulator.cpp \
+    src/RadarWorker.cpp \
+    src/RadarNetwork.cpp \
+    src/FusionEngine.cpp \
+    src/SpatialGrid.cpp \
     src/RadarDisplay.cpp \
+    src/TrackerBank.cpp \
+    src/TrailArena.cpp \
+    src/FrameScheduler.cpp \
+    src/RadarReceiver.cpp \
+    src/RadarSceneRenderer.cpp \
+    src/DensityHeatmap.cpp \
     src/StatisticsManager.cpp \
+    src/StatisticsEvent.cpp \
+    src/EventStore.cpp \
+    src/RollingCounter.cpp \
+    src/StatisticsExporter.cpp \
+    src/EventJournal.cpp \
+    src/LatencyHistogram.cpp \
+    src/MetricsRegistry.cpp \
+    src/MetricsServer.cpp \
+    src/Tracing.cpp \
+    src/Diagnostics.cpp \
     src/WeaponStrategy.cpp
 
 # 头文件
@@ -36,8 +61,30 @@ HEADERS += \
     include/Drone.h \
     include/DroneManager.h \
     include/RadarSimulator.h \
+    include/RadarDetection.h \
+    include/RadarWorker.h \
+    include/RadarNetwork.h \
+    include/FusionEngine.h \
+    include/SpatialGrid.h \
     include/RadarDisplay.h \
+    include/TrackerBank.h \
+    include/TrailArena.h \
+    include/FrameScheduler.h \
+    include/RadarReceiver.h \
+    include/RadarSceneRenderer.h \
+    include/DensityHeatmap.h \
     include/StatisticsManager.h \
+    include/StatisticsEvent.h \
+    include/EventStore.h \
+    include/RollingCounter.h \
+    include/StatisticsExporter.h \
+    include/EventJournal.h \
+    include/LatencyHistogram.h \
+    include/MpscQueue.h \
+    include/MetricsRegistry.h \
+    include/MetricsServer.h \
+    include/Tracing.h \
+    include/Diagnostics.h \
     include/WeaponStrategy.h
 
 # Windows 特定设置
@@ -0,0 +1,47 @@
+#ifndef DENSITYHEATMAP_H
+#define DENSITYHEATMAP_H
+
+#include <QPointF>
+#include <QVector>
+#include <QImage>
+
+// 目标密度热力图：屏幕空间的均匀网格，每帧先整体衰减再累加各目标所在格
+// 格值是目标数的指数滑动平均，绘制时整张网格转成一幅QImage缩放贴图
+class DensityHeatmap
+{
+public:
+    explicit DensityHeatmap(int cellPixels = 8, int decayTimeMs = 1000);
+
+    // 网格覆盖以雷达中心为原点、半边长worldRadius的方形区域，
+    // 分辨率按屏幕半径和每格像素数确定；分辨率或范围变化时清空
+    void configure(double screenRadius, double worldRadius);
+    void setCellPixels(int cellPixels) { m_cellPixels = qMax(1, cellPixels); }
+    void setDecayTime(int decayTimeMs) { m_decayTimeMs = qMax(1, decayTimeMs); }
+    int getCellPixels() const { return m_cellPixels; }
+    int getDecayTime() const { return m_decayTimeMs; }
+    int getResolution() const { return m_resolution; }
+
+    // 每帧调用一次decay()，随后对每个目标调用accumulate()
+    void decay(qint64 elapsedMs);
+    void accumulate(QPointF worldPos);
+    void clear();
+    bool isEmpty() const { return m_empty; }
+
+    // 按需重建图像（每格一个像素），透明处表示无目标
+    const QImage& image();
+
+private:
+    int m_cellPixels;
+    int m_decayTimeMs;
+    int m_resolution;
+    double m_worldRadius;
+    double m_depositWeight;     // 本帧每个目标的累加量 = 1 - 衰减系数
+    bool m_empty;
+    bool m_imageDirty;
+
+    QVector<float> m_bins;
+    QImage m_image;
+    QVector<QRgb> m_palette;    // 预乘颜色表：透明 -> 绿 -> 黄 -> 红
+};
+
+#endif // DENSITYHEATMAP_H
@@ -0,0 +1,34 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <QStringList>
+#include <QTextStream>
+
+// 命令行诊断：不显示主窗口，直接在进程内驱动各组件并把结果打印到标准输出
+//   DroneRadarSystem --self-test      运行全部自检，任一项失败时退出码为1
+//   DroneRadarSystem --benchmark-fusion [航迹数] [雷达源数] [周期数]
+//                                     融合周期基准，平均耗时超过周期预算时退出码为1
+//   DroneRadarSystem --dump-journal <文件>
+//                                     以制表符分隔的文本打印事件日志中的全部记录
+// 没有图形环境时可加 -platform offscreen
+class Diagnostics
+{
+public:
+    // 识别命令行中的诊断参数并执行；没有诊断参数时返回-1，否则返回进程退出码
+    static int run(const QStringList& arguments);
+
+private:
+    static int runSelfTest(QTextStream& out);
+    static int runFusionBenchmark(QTextStream& out, int trackCount, int sourceCount, int cycles);
+    static int dumpJournal(QTextStream& out, const QString& filename);
+
+    // 自检项：通过返回true，失败原因写入out
+    static bool checkNetworkCoverage(QTextStream& out);
+    static bool checkFusionAssociation(QTextStream& out);
+    static bool checkEventStoreOrder(QTextStream& out);
+    static bool checkSectorCrossing(QTextStream& out);
+    static bool checkRenderBufferSwap(QTextStream& out);
+    static bool checkJournalRoundTrip(QTextStream& out);
+};
+
+#endif // DIAGNOSTICS_H
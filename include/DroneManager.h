@@ -6,8 +6,36 @@
 #include <QList>
 #include <QPointF>
 #include <QRandomGenerator>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
 #include "Drone.h"
 
+class MetricTimer;
+class MetricGauge;
+
+// 单架无人机的只读状态（快照用，不含QObject，可跨线程拷贝）
+struct DroneState {
+    int id;
+    QPointF position;
+    QPointF velocity;
+    TrajectoryType trajectoryType;
+    SpeedType speedType;
+    double currentDirection;
+    double currentSpeed;
+};
+
+// 无人机状态快照：每次更新后整体发布，读者拿到的是一致的不可变副本
+struct DroneSnapshot {
+    quint64 sequence = 0;   // 发布序号，单调递增
+    qint64 timestamp = 0;   // 发布时间（毫秒）
+    QVector<DroneState> drones;
+    QHash<int, int> indexById; // 无人机ID -> drones下标
+};
+
+typedef QSharedPointer<const DroneSnapshot> DroneSnapshotPtr;
+
 class DroneManager : public QObject
 {
     Q_OBJECT
@@ -56,6 +84,9 @@ public:
     QList<Drone*> getActiveDrones() const;
     Drone* getDroneById(int id) const;
     
+    // 线程安全的状态快照（雷达线程等非GUI线程只能通过快照读取无人机状态）
+    DroneSnapshotPtr getSnapshot() const;
+    
     // 区域设置
     void setSquareSize(double size) { m_squareSize = size; }
     double getSquareSize() const { return m_squareSize; }
@@ -85,6 +116,15 @@ private:
     int m_generationInterval;
     QRandomGenerator* m_randomGenerator;
     
+    // 双缓冲快照：GUI线程构建新快照后在锁内替换指针，读者持有旧快照不受影响
+    mutable QMutex m_snapshotMutex;
+    DroneSnapshotPtr m_snapshot;
+    quint64 m_snapshotSequence;
+    
+    // 指标：更新节拍耗时、活跃无人机数
+    MetricTimer* m_tickDuration;
+    MetricGauge* m_activeDrones;
+    
     // 私有辅助方法
     DroneType generateRandomDroneType();
     QPointF generateRandomEdgePosition();
@@ -92,6 +132,7 @@ private:
     QPointF generateRandomVelocity(double minSpeed, double maxSpeed);
     QPointF generateRandomVelocityTowardRadar(const QPointF& fromPosition, double minSpeed, double maxSpeed);
     int generateUniqueId();
+    void publishSnapshot();
     // 在DroneManager类中添加以下声明
 private:
     QPointF generateRandomVelocityWithVariation(double minSpeed, double maxSpeed);
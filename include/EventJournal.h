@@ -0,0 +1,103 @@
+#ifndef EVENTJOURNAL_H
+#define EVENTJOURNAL_H
+
+#include <QObject>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QTimer>
+#include <QByteArray>
+#include <QString>
+#include "StatisticsEvent.h"
+
+// 事件日志文件格式（小端）：
+//   文件头 24 字节：magic "EVJL"、版本、记录长度、保留字段、会话开始时间
+//   之后为定长记录，每条 40 字节：时间戳、事件类型、无人机ID、位置x、位置y、数值
+// details文本不写入日志，可由类型和数值重新生成
+struct EventJournalFormat {
+    static const quint32 Magic = 0x45564A4C; // "EVJL"
+    static const quint32 Version = 1;
+    static const int HeaderSize = 24;
+    static const int RecordSize = 40;
+};
+
+// 只追加的事件日志写入器：记录先进入内存批次，满一批或定时器到期时写文件，
+// 定时同步到磁盘（fsync），进程异常退出最多丢失一个同步周期的数据
+// 写文件和fsync都在独立的同步线程中执行，append只做内存编码，不会阻塞调用线程
+class EventJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EventJournal(QObject *parent = nullptr);
+    ~EventJournal();
+
+    // 打开已有日志时校验文件头并从末尾续写；文件头不匹配则返回false
+    bool open(const QString& filename, qint64 sessionStartTime);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString fileName() const { return m_file.fileName(); }
+
+    void setBatchSize(int records) { m_batchRecords = qMax(1, records); }
+    void setSyncInterval(int ms);
+
+    void append(const StatisticsEvent& event);
+    void append(qint64 timestamp, EventType type, int droneId, QPointF position, double value);
+
+    qint64 getRecordCount() const { return m_recordCount; }
+
+public slots:
+    // 写出当前批次并同步到磁盘；可在任意线程调用，返回时数据已落盘
+    void sync();
+
+private:
+    bool writePending();
+
+    QFile m_file;               // 受m_fileMutex保护
+    QByteArray m_writeBuffer;   // 正在写文件的批次，受m_fileMutex保护
+    bool m_unsynced;            // 上次同步后是否写过数据，受m_fileMutex保护
+    QMutex m_fileMutex;
+
+    QByteArray m_pending;       // 尚未写入文件的记录，受m_pendingMutex保护
+    bool m_flushQueued;         // 已请求同步线程写出满批次，受m_pendingMutex保护
+    QMutex m_pendingMutex;      // 加锁顺序：先m_fileMutex后m_pendingMutex
+
+    int m_batchRecords;
+    qint64 m_recordCount;
+    QThread* m_syncThread;
+    QTimer* m_syncTimer;        // 属于m_syncThread
+};
+
+// 日志读取器：整个文件映射到内存，按下标直接解码定长记录，不做文本解析
+class EventJournalReader
+{
+public:
+    EventJournalReader();
+    ~EventJournalReader();
+
+    bool open(const QString& filename);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    qint64 getSessionStartTime() const { return m_sessionStartTime; }
+    qint64 recordCount() const { return m_recordCount; }
+
+    // 解码第index条记录
+    StatisticsEvent record(qint64 index) const;
+
+    template <typename Visitor>
+    void forEach(Visitor visitor) const
+    {
+        for (qint64 i = 0; i < m_recordCount; ++i) {
+            visitor(record(i));
+        }
+    }
+
+private:
+    QFile m_file;
+    const uchar* m_data;
+    qint64 m_recordCount;
+    qint64 m_sessionStartTime;
+};
+
+#endif // EVENTJOURNAL_H
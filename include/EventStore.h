@@ -0,0 +1,186 @@
+#ifndef EVENTSTORE_H
+#define EVENTSTORE_H
+
+#include <QVector>
+#include <limits>
+#include "StatisticsEvent.h"
+
+// 列式事件块：每个字段一个连续数组，没有逐条的堆分配；另按事件类型保存行号，按类型查询只访问匹配的行。
+// 每条事件的列数据约41字节（含类型行号），但每个块还有十几个数组各自的分配开销，
+// 只有行数较多的块才接近这个值——归档因此把逐秒的小桶合并成数千行的大块
+class EventColumns
+{
+public:
+    int size() const { return m_timestamps.size(); }
+    bool isEmpty() const { return m_timestamps.isEmpty(); }
+    // 块内最早/最晚的时间戳；迟到事件会追加到块尾，行不一定按时间排序
+    qint64 minTimestamp() const { return m_minTimestamp; }
+    qint64 maxTimestamp() const { return m_maxTimestamp; }
+
+    void append(const StatisticsEvent& event);
+    // 把另一个块的全部行追加到末尾
+    void appendRows(const EventColumns& other);
+    void clear();
+    void swap(EventColumns& other);
+    // 删除早于cutoffTime的行，返回删除的行数
+    int removeBefore(qint64 cutoffTime);
+
+    qint64 timestampAt(int row) const { return m_timestamps[row]; }
+    EventType typeAt(int row) const { return EventType(m_types[row]); }
+    StatisticsEvent at(int row) const
+    {
+        return StatisticsEvent(m_timestamps[row], EventType(m_types[row]), m_droneIds[row],
+                               QPointF(m_xs[row], m_ys[row]), m_values[row]);
+    }
+    const QVector<int>& rowsOfType(EventType type) const { return m_rowsByType[int(type)]; }
+
+private:
+    QVector<qint64> m_timestamps;
+    QVector<quint8> m_types;
+    QVector<qint32> m_droneIds;
+    QVector<double> m_xs;
+    QVector<double> m_ys;
+    QVector<double> m_values;
+    QVector<int> m_rowsByType[EventTypeCount];   // 各类型的行号，升序
+    qint64 m_minTimestamp = std::numeric_limits<qint64>::max();
+    qint64 m_maxTimestamp = std::numeric_limits<qint64>::min();
+};
+
+// 按时间分区的事件存储：最近一段时间的事件按秒分桶放在环形数组中，
+// 近期窗口查询只访问覆盖窗口的桶；滑出环形窗口的桶按列追加到最后一个归档块（或直接丢弃），
+// 最后一块满ArchiveChunkRows行后才开新块
+class EventStore
+{
+public:
+    explicit EventStore(int ringSeconds = 600);
+
+    // 关闭归档后，滑出环形窗口的事件直接丢弃，内存上限由窗口长度决定
+    void setArchiveEnabled(bool enabled) { m_archiveEnabled = enabled; }
+    bool isArchiveEnabled() const { return m_archiveEnabled; }
+    int getRingSeconds() const { return m_ring.size(); }
+
+    void append(const StatisticsEvent& event);
+    void clear();
+    // 删除早于cutoffTime的事件：整块过期的归档块直接丢弃
+    void removeBefore(qint64 cutoffTime);
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    int countOfType(EventType type) const { return m_typeCounts[int(type)]; }
+
+    // 按时间顺序访问timestamp >= fromTime的事件
+    template <typename Visitor>
+    void forEachInWindow(qint64 fromTime, Visitor visitor) const;
+
+    // 按时间顺序访问全部事件（归档 + 环形窗口）
+    template <typename Visitor>
+    void forEach(Visitor visitor) const;
+
+    // 只访问指定类型的事件：逐块读取类型行号，不检查其他类型的行
+    template <typename Visitor>
+    void forEachOfType(EventType type, Visitor visitor) const;
+
+private:
+    static const int ArchiveChunkRows = 4096;
+
+    struct Bucket {
+        qint64 second = -1;                 // 桶对应的秒（时间戳/1000），-1为空桶
+        EventColumns events;
+    };
+
+    void advanceTo(qint64 second);
+    void retireBucket(Bucket& bucket);
+    void discardRows(const EventColumns& events);
+    qint64 oldestRingSecond() const { return m_newestSecond - m_ring.size() + 1; }
+
+    // 按时间顺序依次访问归档块和环形窗口中的非空桶
+    template <typename ChunkVisitor>
+    void forEachChunk(ChunkVisitor visitor) const;
+
+    QVector<Bucket> m_ring;
+    QVector<EventColumns> m_archive;   // 按时间顺序的冷数据块，除最后一块外都已写满
+    qint64 m_newestSecond;
+    int m_size;
+    int m_typeCounts[EventTypeCount];
+    bool m_archiveEnabled;
+};
+
+template <typename ChunkVisitor>
+void EventStore::forEachChunk(ChunkVisitor visitor) const
+{
+    for (const EventColumns& chunk : m_archive) {
+        visitor(chunk);
+    }
+    if (m_size == 0) {
+        return;
+    }
+    for (qint64 second = oldestRingSecond(); second <= m_newestSecond; ++second) {
+        const Bucket& bucket = m_ring[int(second % m_ring.size())];
+        if (bucket.second == second) {
+            visitor(bucket.events);
+        }
+    }
+}
+
+template <typename Visitor>
+void EventStore::forEachInWindow(qint64 fromTime, Visitor visitor) const
+{
+    if (m_size == 0) {
+        return;
+    }
+
+    qint64 fromSecond = fromTime / 1000;
+    qint64 firstSecond = oldestRingSecond();
+
+    auto visitFrom = [fromTime, &visitor](const EventColumns& chunk) {
+        for (int row = 0; row < chunk.size(); ++row) {
+            if (chunk.timestampAt(row) >= fromTime) {
+                visitor(chunk.at(row));
+            }
+        }
+    };
+
+    // 窗口起点早于环形窗口时才需要扫描归档：各块的最晚时间戳随块序递增，
+    // 从后往前跳过整块过旧的数据
+    if (fromSecond < firstSecond && !m_archive.isEmpty()) {
+        int firstChunk = m_archive.size();
+        while (firstChunk > 0 && m_archive[firstChunk - 1].maxTimestamp() >= fromTime) {
+            --firstChunk;
+        }
+        for (int i = firstChunk; i < m_archive.size(); ++i) {
+            visitFrom(m_archive[i]);
+        }
+    }
+
+    for (qint64 second = qMax(fromSecond, firstSecond); second <= m_newestSecond; ++second) {
+        const Bucket& bucket = m_ring[int(second % m_ring.size())];
+        if (bucket.second == second) {
+            visitFrom(bucket.events);
+        }
+    }
+}
+
+template <typename Visitor>
+void EventStore::forEach(Visitor visitor) const
+{
+    forEachChunk([&visitor](const EventColumns& chunk) {
+        for (int row = 0; row < chunk.size(); ++row) {
+            visitor(chunk.at(row));
+        }
+    });
+}
+
+template <typename Visitor>
+void EventStore::forEachOfType(EventType type, Visitor visitor) const
+{
+    if (m_typeCounts[int(type)] == 0) {
+        return;
+    }
+    forEachChunk([type, &visitor](const EventColumns& chunk) {
+        for (int row : chunk.rowsOfType(type)) {
+            visitor(chunk.at(row));
+        }
+    });
+}
+
+#endif // EVENTSTORE_H
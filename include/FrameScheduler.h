@@ -0,0 +1,61 @@
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+// 帧调度器：以固定帧率节拍驱动界面重绘
+// 所有失效来源只调用invalidate()，同一帧内的多次请求合并为一次重绘；
+// 既没有失效也没有持续动画的帧直接跳过
+class FrameScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FrameScheduler(QObject *parent = nullptr);
+
+    void setTargetFps(int fps);
+    int getTargetFps() const { return m_targetFps; }
+
+    // 请求在下一帧重绘
+    void invalidate() { m_dirty = true; }
+    bool isDirty() const { return m_dirty; }
+
+    // 持续动画来源（按位标记），有任一来源活跃时每帧都重绘
+    void setAnimationActive(quint32 source, bool active);
+    bool isAnimating() const { return m_animationSources != 0; }
+
+    // 由绘制方在实际完成一帧绘制后调用，用于统计实际帧率
+    void framePresented();
+    double getActualFps() const { return m_actualFps; }
+    int getSkippedFrames() const { return m_skippedFrames; }
+
+    void start();
+    void stop();
+
+signals:
+    // 每个节拍先发出frameTick推进动画状态，需要重绘时再发出frameReady
+    void frameTick(qint64 elapsedMs);
+    void frameReady();
+    void fpsUpdated(double fps);
+
+private slots:
+    void onTimerTick();
+
+private:
+    QTimer* m_frameTimer;
+    QElapsedTimer m_clock;
+    int m_targetFps;
+    bool m_dirty;
+    quint32 m_animationSources;
+
+    // 帧率统计
+    qint64 m_lastTickTime;
+    qint64 m_fpsWindowStart;
+    int m_framesInWindow;
+    int m_skippedFrames;
+    double m_actualFps;
+};
+
+#endif // FRAMESCHEDULER_H
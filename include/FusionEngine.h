@@ -0,0 +1,116 @@
+#ifndef FUSIONENGINE_H
+#define FUSIONENGINE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <QPointF>
+#include <QList>
+#include <QPair>
+#include <QHash>
+#include <QVector>
+#include "RadarDetection.h"
+#include "SpatialGrid.h"
+
+class MetricTimer;
+
+// 融合航迹：多个雷达源对同一目标的检测合并后的结果
+struct FusedTrack {
+    int fusedId;
+    int droneId;            // 权重最大的贡献检测对应的无人机ID
+    QPointF position;
+    QPointF velocity;
+    qint64 lastUpdateTime;
+    int sourceCount;        // 最近一个周期参与融合的检测数量
+};
+
+Q_DECLARE_METATYPE(FusedTrack)
+
+// 航迹融合引擎：缓存各雷达源最近一次上报的检测，按固定周期统一关联
+// 关联采用空间网格门限：每个检测匹配门限内预测位置最近的融合航迹，按距离加权合并
+// 定时器在start()中创建，因此可以先moveToThread()再启动
+class FusionEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FusionEngine(QObject *parent = nullptr);
+    ~FusionEngine();
+
+    void setGateRadius(double radius) { m_gateRadius = radius; }
+    void setTrackTimeout(int timeoutMs) { m_trackTimeoutMs = timeoutMs; }
+    double getGateRadius() const { return m_gateRadius; }
+    int getTrackTimeout() const { return m_trackTimeoutMs; }
+    int getCycleInterval() const { return m_cycleInterval; }
+
+    // 性能统计（微秒）
+    qint64 getLastCycleTime() const { return m_lastCycleUs; }
+    qint64 getMaxCycleTime() const { return m_maxCycleUs; }
+
+    static QByteArray serializeFusedTracks(const QList<FusedTrack>& tracks);
+
+    // 基准测试：trackCount个目标各被sourceCount个雷达源同时观测，连续执行cycles个融合周期
+    struct BenchmarkResult {
+        int trackCount;
+        int sourceCount;
+        int cycles;
+        int fusedTracks;        // 最后一个周期结束时的融合航迹数，关联正确时等于trackCount
+        int multiSourceTracks;  // 其中由全部雷达源共同更新的航迹数
+        qint64 averageCycleUs;
+        qint64 maxCycleUs;
+        qint64 budgetUs;        // 周期预算（默认100毫秒）
+    };
+    // 在调用线程中同步运行，不启动定时器、不发送数据
+    static BenchmarkResult runBenchmark(int trackCount, int sourceCount, int cycles);
+
+public slots:
+    void start(int cycleMs = 100);
+    void stop();
+    void submitDetections(int sourceId, const QList<RadarDetection>& detections);
+    void removeSource(int sourceId);
+    void addClient(const QHostAddress& address, quint16 port);
+    void reset();
+
+signals:
+    void fusedTracksUpdated(QList<FusedTrack> tracks);
+
+private slots:
+    void performFusionCycle();
+
+private:
+    // 每周期的合并累加量，与m_tracks按下标一一对应
+    struct FusionAccumulator {
+        double weight;
+        double bestWeight;
+        QPointF weightedPosition;
+        QPointF weightedVelocity;
+        int bestDroneId;
+        int count;
+        int lastSourceId;   // 同一雷达源在一个周期内只向同一航迹贡献一次
+    };
+
+    void accumulate(int slot, int sourceId, const RadarDetection& detection);
+    int createTrack(const RadarDetection& detection, qint64 currentTime);
+
+    QTimer* m_cycleTimer;
+    QUdpSocket* m_udpSocket;
+    QList<QPair<QHostAddress, quint16>> m_clients;
+
+    QHash<int, QList<RadarDetection>> m_pendingDetections; // 雷达源ID -> 最近一次检测
+    QVector<FusedTrack> m_tracks;
+    QVector<FusionAccumulator> m_accumulators;
+    SpatialGrid m_trackGrid;       // 预测位置 -> m_tracks下标
+
+    int m_nextFusedId;
+    int m_cycleInterval;
+    double m_gateRadius;
+    int m_trackTimeoutMs;
+    qint64 m_lastCycleTime;
+    qint64 m_lastCycleUs;
+    qint64 m_maxCycleUs;
+    QList<FusedTrack> m_lastFusedTracks;   // 最近一个周期的输出（基准测试用）
+    MetricTimer* m_cycleDuration;
+};
+
+#endif // FUSIONENGINE_H
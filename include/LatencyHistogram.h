@@ -0,0 +1,45 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QVector>
+
+// 对数分桶延迟直方图（HDR风格）：按2的幂分段，每段再均分为32个子桶，
+// 任意数值的相对误差不超过1/32；记录O(1)，百分位查询只扫描桶数组
+// 数值单位由调用方决定（统计模块统一用毫秒），负值按0记录
+// 所有实例使用相同的分桶参数，因此可以直接合并；复制即得到快照（桶数组隐式共享）
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(qint64 value, qint64 count = 1);
+    void merge(const LatencyHistogram& other);
+    void clear();
+
+    qint64 count() const { return m_totalCount; }
+    bool isEmpty() const { return m_totalCount == 0; }
+    qint64 min() const { return m_totalCount > 0 ? m_min : 0; }
+    qint64 max() const { return m_max; }
+    double mean() const { return m_totalCount > 0 ? m_sum / m_totalCount : 0.0; }
+
+    // percentile取0~100；返回值为所在桶的上界（不超过实际最大值）
+    qint64 valueAtPercentile(double percentile) const;
+    qint64 p50() const { return valueAtPercentile(50.0); }
+    qint64 p90() const { return valueAtPercentile(90.0); }
+    qint64 p99() const { return valueAtPercentile(99.0); }
+
+private:
+    static const int SubBucketBits = 5;
+    static const int SubBucketCount = 1 << SubBucketBits;
+
+    static int bucketIndex(qint64 value);
+    static qint64 bucketUpperBound(int index);
+
+    QVector<qint64> m_counts;   // 按需增长，只覆盖出现过的最大桶
+    qint64 m_totalCount;
+    qint64 m_min;
+    qint64 m_max;
+    double m_sum;
+};
+
+#endif // LATENCYHISTOGRAM_H
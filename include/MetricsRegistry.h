@@ -0,0 +1,98 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// 单调递增计数器
+class MetricCounter
+{
+public:
+    void add(quint64 n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> m_value{0};
+};
+
+// 瞬时值，由数据所有者推送
+class MetricGauge
+{
+public:
+    void set(double value) { m_value.store(value, std::memory_order_relaxed); }
+    double value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_value{0.0};
+};
+
+// 耗时统计（微秒）：累计次数、总耗时，以及最近一分钟内的最大值。
+// 最大值按10秒分片滚动：每个分片把所属时间片序号和该片内最大值打包在一个原子量里，
+// 读取时合并仍在窗口内的分片，不清零，多个抓取方互不影响
+class MetricTimer
+{
+public:
+    void record(qint64 microseconds);
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    quint64 sumMicroseconds() const { return m_sumUs.load(std::memory_order_relaxed); }
+    qint64 maxMicroseconds() const;
+
+private:
+    static const int MaxSlices = 6;
+    static const qint64 MaxSliceMs = 10000;
+
+    std::atomic<quint64> m_count{0};
+    std::atomic<quint64> m_sumUs{0};
+    std::atomic<quint64> m_maxSlices[MaxSlices] = {};   // 高24位为时间片序号，低40位为最大值
+};
+
+// 进程级指标注册表：注册时加锁并返回地址固定的指标对象，之后的更新只做原子操作，
+// 任意线程都可以写入；导出时按Prometheus文本格式渲染
+// 同名同标签重复注册返回同一个对象，调用方通常在首次使用时取得指针并缓存
+class MetricsRegistry
+{
+public:
+    static MetricsRegistry& instance();
+
+    // labels为Prometheus标签体，例如 client="127.0.0.1:12346"
+    MetricCounter* counter(const QString& name, const QString& help, const QString& labels = QString());
+    MetricGauge* gauge(const QString& name, const QString& help, const QString& labels = QString());
+    // 导出为 <name>_count、<name>_sum（秒）以及 <name>_max（最近一分钟的最大值，秒）
+    MetricTimer* timer(const QString& name, const QString& help, const QString& labels = QString());
+
+    QByteArray renderPrometheus();
+
+private:
+    MetricsRegistry() = default;
+
+    enum class Kind { Counter, Gauge, Timer };
+    struct Series {
+        QString labels;
+        MetricCounter* counter = nullptr;
+        MetricGauge* gauge = nullptr;
+        MetricTimer* timer = nullptr;
+    };
+    struct Family {
+        QString name;
+        QString help;
+        Kind kind;
+        QVector<Series> series;
+    };
+
+    Series& series(const QString& name, const QString& help, Kind kind, const QString& labels);
+
+    QMutex m_mutex;
+    QVector<Family> m_families;             // 按注册顺序导出
+    QHash<QString, int> m_familyIndex;
+    std::vector<std::unique_ptr<MetricCounter>> m_counters;
+    std::vector<std::unique_ptr<MetricGauge>> m_gauges;
+    std::vector<std::unique_ptr<MetricTimer>> m_timers;
+};
+
+#endif // METRICSREGISTRY_H
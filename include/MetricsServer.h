@@ -0,0 +1,64 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QThread>
+#include <QHash>
+#include <QByteArray>
+
+class QTcpServer;
+class QTcpSocket;
+
+// 指标服务工作者：运行在独立线程中，只监听本机地址，GET /metrics 返回注册表的Prometheus文本
+// 每个连接应答一次后关闭，5秒内未发完请求头的连接被断开；抓取只读取原子量，不经过GUI线程
+class MetricsServerWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServerWorker(QObject *parent = nullptr);
+
+public slots:
+    // 以下槽函数均应通过排队调用在工作线程中执行
+    void listen(quint16 port);
+    void shutdown();
+
+signals:
+    void listeningChanged(bool listening, quint16 port);
+
+private slots:
+    void handleNewConnection();
+
+private:
+    void handleReadyRead(QTcpSocket* socket);
+    void respond(QTcpSocket* socket, const QByteArray& status, const QByteArray& body);
+
+    QTcpServer* m_server;
+    QHash<QTcpSocket*, QByteArray> m_requests;  // 尚未读完请求头的连接
+};
+
+// 指标服务：GUI线程侧的外观对象，首次start()时创建工作线程
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(QObject *parent = nullptr);
+    ~MetricsServer();
+
+    void start(quint16 port = 9464);
+    void stop();
+    bool isListening() const { return m_listening; }
+    quint16 getPort() const { return m_port; }
+
+signals:
+    void listeningChanged(bool listening, quint16 port);
+
+private:
+    QThread* m_workerThread;
+    MetricsServerWorker* m_worker;
+    bool m_listening;
+    quint16 m_port;
+};
+
+#endif // METRICSSERVER_H
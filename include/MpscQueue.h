@@ -0,0 +1,85 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+
+// 有界无锁多生产者/单消费者队列（Vyukov环形数组算法）：
+// 每个槽位带一个序号，生产者用一次CAS抢占写入位置，写完后发布序号；
+// 消费者只有一个，读取位置不需要原子操作。队列满时tryPush返回false，由调用方决定丢弃或重试
+template <typename T>
+class MpscQueue
+{
+public:
+    // 容量向上取整到2的幂
+    explicit MpscQueue(int capacity = 4096)
+    {
+        quint64 size = 2;
+        while (size < quint64(qMax(2, capacity))) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_cells.reset(new Cell[size]);
+        for (quint64 i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_enqueuePos.store(0, std::memory_order_relaxed);
+        m_dequeuePos = 0;
+    }
+
+    int capacity() const { return int(m_mask + 1); }
+
+    // 任意线程调用
+    bool tryPush(const T& value)
+    {
+        quint64 pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            quint64 sequence = cell->sequence.load(std::memory_order_acquire);
+            qint64 diff = qint64(sequence) - qint64(pos);
+            if (diff == 0) {
+                // 槽位空闲：抢占写入位置，失败时pos被更新为最新值后重试
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // 消费者还没取走上一轮的数据，队列已满
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只能由唯一的消费者线程调用
+    bool tryPop(T& value)
+    {
+        Cell& cell = m_cells[m_dequeuePos & m_mask];
+        quint64 sequence = cell.sequence.load(std::memory_order_acquire);
+        if (qint64(sequence) - qint64(m_dequeuePos + 1) < 0) {
+            return false; // 空，或生产者已抢占位置但尚未写完
+        }
+        value = cell.value;
+        // 槽位交还给下一轮的生产者
+        cell.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+        ++m_dequeuePos;
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<quint64> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    quint64 m_mask;
+    alignas(64) std::atomic<quint64> m_enqueuePos;   // 生产者共享
+    alignas(64) quint64 m_dequeuePos;                // 消费者独占
+};
+
+#endif // MPSCQUEUE_H
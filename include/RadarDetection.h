@@ -0,0 +1,28 @@
+#ifndef RADARDETECTION_H
+#define RADARDETECTION_H
+
+#include <QPointF>
+#include <QList>
+#include <QMetaType>
+#include "Drone.h"
+
+struct RadarDetection {
+    int droneId;
+    QPointF position;
+    QPointF velocity;
+    qint64 detectionTime;
+    double distance;
+    double azimuth; // 方位角
+    
+    // 新轨迹系统字段
+    TrajectoryType trajectoryType = TrajectoryType::Linear;
+    SpeedType speedType = SpeedType::Constant;
+    double currentDirection = 0.0; // 当前方向角度（弧度）
+    double currentSpeed = 0.0;     // 新轨迹系统的实际速度（米/秒）
+    bool useNewTrajectory = false; // 是否使用新轨迹系统
+};
+
+// 跨线程排队信号需要注册元类型
+Q_DECLARE_METATYPE(RadarDetection)
+
+#endif // RADARDETECTION_H
@@ -3,14 +3,24 @@
 
 #include <QWidget>
 #include <QPainter>
+#include <QPixmap>
 #include <QTimer>
-#include <QUdpSocket>
+#include <QThread>
 #include <QHostAddress>
 #include <QPointF>
 #include <QList>
+#include <QVector>
+#include <QHash>
 #include <QColor>
 #include "RadarSimulator.h"
 #include "Drone.h"
+#include "TrackerBank.h"
+#include "SpatialGrid.h"
+#include "TrailArena.h"
+#include "FrameScheduler.h"
+#include "RadarReceiver.h"
+#include "RadarSceneRenderer.h"
+#include "DensityHeatmap.h"
 
 struct DisplayDrone {
     int id;
@@ -20,7 +30,7 @@ struct DisplayDrone {
     double distance;
     double azimuth;
     QColor color;
-    QList<QPointF> trail; // 轨迹点
+    int trailSlot = -1;   // 轨迹点在TrailArena中的槽位
     DroneType type;        // 无人机类型
     int threatLevel;       // 威胁等级
     double threatScore;    // 威胁评分
@@ -31,6 +41,12 @@ struct DisplayDrone {
     double currentDirection = 0.0; // 当前方向角度（弧度）
     double currentSpeed = 0.0;     // 新轨迹系统的实际速度（米/秒）
     bool useNewTrajectory = false; // 是否使用新轨迹系统
+    bool coasting = false;         // 漏扫外推中（位置为滤波器预测值）
+    
+    // 航位推算：position为最近一次定位，renderPosition为绘制时外推的位置
+    QPointF renderPosition;
+    QPointF correctionOffset;      // 新帧到达时的平滑修正量，随时间衰减到0
+    qint64 correctionStartTime = 0;
 };
 
 class RadarDisplay : public QWidget
@@ -47,20 +63,47 @@ public:
     bool isConnected() const;
     
     // 显示设置
-    void setRadarRadius(double radius) { m_radarRadius = radius; update(); }
-    void setShowTrails(bool show) { m_showTrails = show; update(); }
-    void setShowInfo(bool show) { m_showInfo = show; update(); }
-    void setTrailLength(int length) { m_trailLength = length; }
+    void setRadarRadius(double radius);
+    void setShowTrails(bool show) { m_showTrails = show; m_frameScheduler->invalidate(); }
+    void setShowInfo(bool show) { m_showInfo = show; m_frameScheduler->invalidate(); }
+    void setTrailLength(int length) { m_trailLength = length; m_trailArena.setCapacity(length); }
+    void setTrailFadeTime(int fadeMs) { m_trailFadeMs = fadeMs; }
+    void setLodThreshold(int trackCount) { m_lodThreshold = trackCount; m_frameScheduler->invalidate(); }
+    void setHeatmapThreshold(int trackCount) { m_heatmapThreshold = trackCount; m_frameScheduler->invalidate(); }
+    void setCoastTimeout(int timeoutMs) { m_coastTimeoutMs = timeoutMs; }
+    TrackerBank& trackerBank() { return m_trackerBank; }
     
     double getRadarRadius() const { return m_radarRadius; }
     bool getShowTrails() const { return m_showTrails; }
     bool getShowInfo() const { return m_showInfo; }
     int getTrailLength() const { return m_trailLength; }
+    int getTrailFadeTime() const { return m_trailFadeMs; }
+    int getLodThreshold() const { return m_lodThreshold; }
+    int getHeatmapThreshold() const { return m_heatmapThreshold; }
+    bool isHeatmapActive() const { return m_drones.size() > m_heatmapThreshold; }
+    DensityHeatmap& heatmap() { return m_heatmap; }
+    
+    // 航位推算：两帧之间按速度外推目标位置
+    void setDeadReckoning(bool enabled);
+    bool getDeadReckoning() const { return m_deadReckoning; }
+    void setSnapDistance(double distance) { m_snapDistance = distance; }
     double getScaleFactor() const { return m_scaleFactor; }
     
+    // 后台渲染：动态图层在独立线程中光栅化为QImage，paintEvent只贴图
+    void setBackgroundRendering(bool enabled);
+    bool getBackgroundRendering() const { return m_backgroundRendering; }
+    
     // 激光锁定功能
-    void setLaserTarget(int droneId) { m_laserTargetId = droneId; update(); }
-    void clearLaserTarget() { m_laserTargetId = -1; update(); }
+    void setLaserTarget(int droneId)
+    {
+        m_laserTargetId = droneId;
+        m_frameScheduler->setAnimationActive(LaserLockAnimation, droneId != -1); // 锁定圆圈闪烁
+        m_frameScheduler->invalidate();
+    }
+    void clearLaserTarget() { setLaserTarget(-1); }
+    
+    // 帧调度
+    FrameScheduler* frameScheduler() const { return m_frameScheduler; }
     
     // 清除显示
     void clearDisplay();
@@ -93,6 +136,8 @@ signals:
     void droneDataReceived(int droneCount);
     void strikeRequested(QPointF center, double radius); // 新增：鼠标点击打击信号
     void droneClicked(int droneId, QPointF position); // 新增：无人机点击信号
+    void frameRateUpdated(double fps);
+    void radarFrameDisplayed(qint64 latencyMs); // 雷达帧从扫描到应用于显示的延迟
 
 protected:
     void paintEvent(QPaintEvent* event) override;
@@ -103,27 +148,37 @@ protected:
 
 private slots:
     void handleDataReceived();
-    void updateDisplay();
+    void advanceAnimations(qint64 elapsedMs);
+    void handleFrameRendered();
     void cleanupOldDrones();
 
 private:
-    void parseRadarData(const QByteArray& data);
     void processRadarData(const QList<RadarDetection>& detections);
+    void applyRadarFrame(const RadarFrame& frame);
+    void removeDroneAt(int index);
+    QPointF extrapolatePosition(const DisplayDrone& drone, qint64 time) const;
+    int hitTestDrone(QPointF widgetPos, double tolerance);
     QPointF worldToScreen(QPointF worldPos);
     QPointF screenToWorld(QPointF screenPos);
     void drawRadarGrid(QPainter& painter);
-    void drawDrones(QPainter& painter);
-    void drawDroneInfo(QPainter& painter, const DisplayDrone& drone);
-    void drawDroneTrail(QPainter& painter, const DisplayDrone& drone);
-    void drawStrikeHighlight(QPainter& painter);
-    void drawStrikeEffects(QPainter& painter);
+    void ensureGridCache();
+    void invalidateGridCache() { m_gridCacheDirty = true; }
+    void updateScaleFactor();
+    void buildScene(RadarScene& scene);
+    void requestBackgroundFrame();
     void drawStrikeCursor(QPainter& painter);
     void drawHoverEffect(QPainter& painter);
     QColor getDroneColor(int droneId);
     QColor getThreatBasedColor(double threatScore); // 根据威胁值获取颜色
+    void syncBeamAngle(double beamStart, double beamWidth, int sectorIndex, int sectorCount);
     
-    // 网络连接
-    QUdpSocket* m_udpSocket;
+    // 网络连接：接收器在独立线程中解码，经无锁队列把帧交给GUI线程
+    QThread* m_receiverThread;
+    RadarReceiver* m_receiver;
+    bool m_receiverBound;
+    quint64 m_skippedRadarFrames;   // 因界面滞后被跳过的全量帧
+    qint64 m_lastFrameTime;         // 最近应用的雷达帧时间戳，更旧的帧不再应用
+    QVector<const RadarFrame*> m_pendingFrames;   // 本次取出的帧（队列+溢出槽），按时间戳排序后应用
     QHostAddress m_serverAddress;
     quint16 m_serverPort;
     
@@ -134,12 +189,54 @@ private:
     bool m_showTrails;
     bool m_showInfo;
     int m_trailLength;
+    int m_trailFadeMs;           // 轨迹点存活时间，按时间线性淡出
+    int m_lodThreshold;          // 目标数超过该值时改用点精灵绘制
+    int m_heatmapThreshold;      // 目标数超过该值时改为密度热力图
+    bool m_deadReckoning;        // 是否在绘制时外推目标位置
+    double m_snapDistance;       // 修正偏差超过该值（米，曼哈顿距离）时直接跳变
+    int m_correctionBlendMs;     // 平滑修正的过渡时间
+    
+    // 静态背景层：背景、距离圈、方位线和标签只在尺寸或半径变化时重绘
+    QPixmap m_gridCache;
+    bool m_gridCacheDirty;
     
-    // 无人机数据
-    QList<DisplayDrone> m_drones;
-    QTimer* m_updateTimer;
+    // 无人机数据：连续存储 + ID索引，删除时交换到末尾
+    QVector<DisplayDrone> m_drones;
+    QHash<int, int> m_droneIndex;   // 无人机ID -> m_drones下标
+    TrailArena m_trailArena;        // 所有航迹的环形轨迹缓冲
+    DensityHeatmap m_heatmap;       // 大规模目标时的密度聚合层
+    
+    // 动态图层：每帧从界面状态生成场景快照，同步模式直接绘制，后台模式交给渲染线程
+    RadarScene m_scene;
+    RadarSceneRenderer m_sceneRenderer;
+    QThread* m_renderThread;
+    RadarRenderWorker* m_renderWorker;
+    bool m_backgroundRendering;
+    bool m_renderInFlight;       // 渲染线程正在处理一帧
+    bool m_renderPending;        // 处理期间又有新的重绘请求
+    
+    // 鼠标命中测试用的屏幕空间网格（以窗口中心为原点）
+    SpatialGrid m_hitGrid;
+    bool m_hitGridDirty;
+    double m_hitGridScale;
+    qint64 m_hitGridTime;          // 网格建立时刻；航位推算的逐帧移动不重建网格
+    double m_hitGridMaxSpeed;      // 建网格时目标的最大外推速度（米/秒）
+    double m_hitGridMaxCorrection; // 建网格时最大的平滑修正量（米）
+    TrackerBank m_trackerBank;   // 航迹滤波，漏扫时外推位置
+    int m_coastTimeoutMs;        // 外推时限，超过后删除航迹
     QTimer* m_cleanupTimer;
     
+    // 统一帧调度
+    enum AnimationSource : quint32 {
+        SweepAnimation = 0x1,
+        StrikeEffectAnimation = 0x2,
+        LaserLockAnimation = 0x4,
+        HoverAnimation = 0x8,
+        MotionAnimation = 0x10,
+        HeatmapAnimation = 0x20
+    };
+    FrameScheduler* m_frameScheduler;
+    
     // 颜色列表
     QList<QColor> m_droneColors;
     
@@ -175,17 +272,21 @@ private:
     
     // 新增：多重打击效果
     QList<StrikeEffect> m_strikeEffects;
-    QTimer* m_strikeEffectTimer;
     
     // 新增：动画参数
     int m_animationPhase;
-    QTimer* m_animationTimer;
     
     // 新增：扫描线动画
     double m_scanAngle;
-    QTimer* m_scanTimer;
     bool m_radarRunning; // 雷达运行状态
     
+    // 旋转波束同步：扫描线角度跟随服务器扇区帧
+    double m_beamSyncAngle;      // 最近一次扇区帧的波束前沿角（度）
+    double m_beamWidthDegrees;   // 扇区宽度（度）
+    double m_beamRateDegPerMs;   // 估计的波束角速度
+    qint64 m_lastBeamSyncTime;
+    qint64 m_beamRotationMs;     // 估计的波束旋转周期
+    
     // 新增：hover状态
     int m_hoveredDroneId;
     QPointF m_hoveredDronePosition;
@@ -0,0 +1,124 @@
+#ifndef RADARNETWORK_H
+#define RADARNETWORK_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <QPointF>
+#include <QList>
+#include <QPair>
+#include <QVector>
+#include <QString>
+#include "DroneManager.h"
+#include "RadarDetection.h"
+#include "SpatialGrid.h"
+#include "FusionEngine.h"
+
+// 雷达站点：一个独立的探测覆盖区域及其数据订阅者
+struct RadarSite {
+    int siteId = -1;
+    QString name;
+    QPointF center;
+    double radius = 800.0;
+    QList<QPair<QHostAddress, quint16>> clients;
+};
+
+// 雷达网络工作者：运行在独立线程中
+// 每个节拍把快照中的无人机建立一次空间网格索引，所有站点的覆盖查询共享这一索引
+class RadarNetworkWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RadarNetworkWorker(DroneManager* droneManager, QObject *parent = nullptr);
+    ~RadarNetworkWorker();
+
+    // 对一个快照计算单个站点的覆盖检测（同一快照的索引只建立一次）；
+    // 扫描定时器和诊断工具共用这一路径
+    QList<RadarDetection> scanSite(const DroneSnapshot& snapshot, const RadarSite& site, qint64 detectionTime);
+
+public slots:
+    // 以下槽函数均应通过排队调用在工作线程中执行
+    void initialize();
+    void shutdown();
+    void startScanning(int intervalMs);
+    void stopScanning();
+    void setScanInterval(int intervalMs);
+    void setSites(const QVector<RadarSite>& sites);
+
+signals:
+    void siteScanCompleted(int siteId, QList<RadarDetection> detections);
+    void networkScanCompleted(int siteCount, int totalDetections);
+
+private slots:
+    void performNetworkScan();
+
+private:
+    void rebuildDroneIndex(const DroneSnapshot& snapshot);
+    void sendDataToClients(const RadarSite& site, const QByteArray& data);
+
+    DroneManager* m_droneManager;   // 仅用于getSnapshot()，该方法线程安全
+    QTimer* m_scanTimer;
+    QUdpSocket* m_udpSocket;
+    int m_scanInterval;
+
+    QVector<RadarSite> m_sites;
+    SpatialGrid m_droneGrid;        // 快照下标的空间索引
+    quint64 m_indexedSequence;      // 当前索引对应的快照序号
+    bool m_indexValid;
+};
+
+// 雷达网络：在同一个DroneManager上托管多个覆盖区域可重叠的雷达站点
+// GUI线程侧的外观对象，站点配置在这里维护并同步到工作线程；
+// 融合引擎与扫描工作者在同一线程中，各站点的检测直接提交给引擎，不经过GUI线程
+class RadarNetwork : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RadarNetwork(DroneManager* droneManager, QObject *parent = nullptr);
+    ~RadarNetwork();
+
+    // 站点管理
+    int addSite(QPointF center, double radius, const QString& name = QString());
+    bool removeSite(int siteId);
+    void removeAllSites();
+    bool addSiteClient(int siteId, const QHostAddress& address, quint16 port);
+    QVector<RadarSite> getSites() const { return m_sites; }
+    int getSiteCount() const { return m_sites.size(); }
+
+    // 扫描控制
+    void startNetwork(int intervalMs = 1000);
+    void stopNetwork();
+    bool isRunning() const { return m_running; }
+    void setScanInterval(int intervalMs);
+    int getScanInterval() const { return m_scanInterval; }
+
+    // 航迹融合：按固定周期把各站点最近一次的检测关联成融合航迹
+    void setFusionEnabled(bool enabled, int cycleMs = 100);
+    bool isFusionEnabled() const { return m_fusionEnabled; }
+
+signals:
+    // 每个站点每次扫描各自发布一次
+    void siteScanCompleted(int siteId, QList<RadarDetection> detections);
+    void networkScanCompleted(int siteCount, int totalDetections);
+    void fusedTracksUpdated(QList<FusedTrack> tracks);
+
+private:
+    void syncSites();
+    int findSite(int siteId) const;
+
+    QThread* m_workerThread;
+    RadarNetworkWorker* m_worker;
+    FusionEngine* m_fusionEngine;   // 属于工作线程
+
+    QVector<RadarSite> m_sites;
+    int m_nextSiteId;
+    int m_scanInterval;
+    bool m_running;
+    bool m_fusionEnabled;
+};
+
+#endif // RADARNETWORK_H
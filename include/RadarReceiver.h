@@ -0,0 +1,113 @@
+#ifndef RADARRECEIVER_H
+#define RADARRECEIVER_H
+
+#include <QObject>
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <QByteArray>
+#include <QVector>
+#include <atomic>
+#include "RadarDetection.h"
+
+// 解码后的一帧雷达数据，槽位预先分配并循环复用
+struct RadarFrame {
+    quint32 version = 0;
+    qint64 timestamp = 0;
+
+    // 版本2扇区帧的波束信息
+    double beamStart = 0.0;
+    double beamWidth = 0.0;
+    int sectorIndex = 0;
+    int sectorCount = 0;
+
+    QList<RadarDetection> detections;   // 只缩小不释放，容量在复用中保留
+
+    bool isSectorFrame() const { return version == 2; }
+};
+
+// 单生产者/单消费者无锁环形队列：接收线程写入，GUI线程读取
+// 队列满时新帧写入溢出槽（三缓冲），覆盖尚未取走的溢出帧，最新一帧永远不会被拒绝
+class RadarFrameQueue
+{
+public:
+    explicit RadarFrameQueue(int capacity = 16, int reservedDetections = 256);
+
+    int capacity() const { return m_frames.size(); }
+
+    // 生产者：取得可写槽位（队列满时返回nullptr），写完后commitWrite()
+    RadarFrame* beginWrite();
+    void commitWrite();
+    // 生产者：队列满时取得溢出槽的私有缓冲，写完后commitOverwrite()发布；
+    // 返回true表示覆盖了一个消费者尚未取走的溢出帧
+    RadarFrame* beginOverwrite() { return &m_overflow[m_overflowBack]; }
+    bool commitOverwrite();
+
+    // 消费者：查看第offset个可读帧，处理完后consume(count)归还槽位
+    int available() const;
+    const RadarFrame& peek(int offset) const;
+    void consume(int count);
+    // 消费者：取走最新的溢出帧（没有则返回nullptr）。溢出帧可能在槽中停留到队列腾空之后，
+    // 不一定比队列中的帧新，消费者应按帧时间戳排序；返回的指针在下一次takeOverflow()之前有效
+    const RadarFrame* takeOverflow();
+
+private:
+    static const int OverflowFresh = 4;   // m_overflowMiddle中的"未取走"标志位
+
+    QVector<RadarFrame> m_frames;
+    std::atomic<quint64> m_head;    // 生产者写入位置
+    std::atomic<quint64> m_tail;    // 消费者读取位置
+
+    // 溢出三缓冲：生产者独占back，消费者独占front，两者通过原子交换middle传递
+    RadarFrame m_overflow[3];
+    int m_overflowBack;
+    int m_overflowFront;
+    std::atomic<int> m_overflowMiddle;
+};
+
+// 雷达数据接收器：运行在独立线程中，取空套接字并直接解码到队列的预分配帧中
+class RadarReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RadarReceiver(QObject *parent = nullptr);
+    ~RadarReceiver();
+
+    RadarFrameQueue& queue() { return m_queue; }
+
+    // 消费者取走队列前调用，之后新到的帧会再次触发framesAvailable
+    void acknowledgeFrames() { m_notifyPending.store(false, std::memory_order_release); }
+
+    // 统计
+    quint64 getReceivedFrames() const { return m_receivedFrames.load(std::memory_order_relaxed); }
+    // 队列满时写入溢出槽、又在显示前被更新帧覆盖的帧
+    quint64 getDroppedFrames() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+    quint64 getMalformedFrames() const { return m_malformedFrames.load(std::memory_order_relaxed); }
+
+    // 按RDAR协议（QDataStream Qt_5_15，大端）解码一个数据报
+    static bool decodeFrame(const char* data, int size, RadarFrame& frame);
+
+public slots:
+    // 以下槽函数均应在接收线程中执行
+    bool bindSocket(const QHostAddress& address, quint16 port);
+    void closeSocket();
+
+signals:
+    // 合并通知：消费者确认之前只发出一次
+    void framesAvailable();
+
+private slots:
+    void readPendingDatagrams();
+
+private:
+    QUdpSocket* m_udpSocket;
+    QByteArray m_datagramBuffer;    // 复用的接收缓冲区
+    RadarFrameQueue m_queue;
+
+    std::atomic<bool> m_notifyPending;
+    std::atomic<quint64> m_receivedFrames;
+    std::atomic<quint64> m_droppedFrames;
+    std::atomic<quint64> m_malformedFrames;
+};
+
+#endif // RADARRECEIVER_H
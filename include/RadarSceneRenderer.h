@@ -0,0 +1,127 @@
+#ifndef RADARSCENERENDERER_H
+#define RADARSCENERENDERER_H
+
+#include <QObject>
+#include <QPainter>
+#include <QPainterPath>
+#include <QImage>
+#include <QMutex>
+#include <QLineF>
+#include <QPointF>
+#include <QSize>
+#include <QVector>
+#include <QHash>
+#include <QColor>
+#include <atomic>
+#include "TrailArena.h"
+
+// 渲染用的目标快照：位置已外推，朝向、速度等显示量已算好
+struct RenderDrone {
+    int id = 0;
+    QPointF position;       // 世界坐标
+    double angle = 0.0;     // 三角形旋转角（弧度，三角形默认向上）
+    QRgb color = 0;
+    bool coasting = false;
+    double speed = 0.0;
+    double distance = 0.0;
+    int trailBegin = 0;     // 在RadarScene::trailPoints中的起始下标（从最老的点开始）
+    int trailCount = 0;
+};
+
+struct RenderStrikeEffect {
+    QPointF center;
+    double radius = 0.0;
+    double progress = 0.0;  // 动画进度 0.0 ~ 1.0
+    int pulsePhase = 0;
+};
+
+// 一帧动态图层的完整描述，按值传给渲染线程，渲染期间不再访问界面状态
+struct RadarScene {
+    QSize size;
+    qreal devicePixelRatio = 1.0;
+    double scaleFactor = 1.0;
+    double radarRadius = 0.0;
+    qint64 time = 0;
+
+    bool radarRunning = false;
+    double scanAngle = 0.0;
+
+    bool showTrails = true;
+    bool showInfo = true;
+    bool spriteMode = false;
+    bool heatmapMode = false;   // 目标过多时只画密度热力图
+    QImage heatmap;             // 覆盖[-radarRadius, radarRadius]方形区域
+    int laserTargetIndex = -1;  // 激光锁定目标在drones中的下标
+    int trailFadeMs = 8000;
+
+    bool showStrikeHighlight = false;
+    QPointF strikeCenter;
+    double strikeRadius = 0.0;
+
+    QVector<RenderDrone> drones;
+    QVector<TrailPoint> trailPoints;
+    QVector<RenderStrikeEffect> strikeEffects;
+};
+
+// 动态图层绘制：扫描线、轨迹、目标、标签和打击效果
+// 只依赖RadarScene，可在GUI线程直接绘制，也可在渲染线程绘制到QImage
+// 调用前画笔坐标系原点应已平移到雷达中心
+class RadarSceneRenderer
+{
+public:
+    void render(QPainter& painter, const RadarScene& scene);
+
+private:
+    QPointF toScreen(QPointF worldPos) const { return worldPos * m_scaleFactor; }
+    void ensureSweepTexture(double screenRadius, qreal pixelRatio);
+    void drawScanSweep(QPainter& painter, const RadarScene& scene);
+    void drawTrails(QPainter& painter, const RadarScene& scene);
+    void drawDrones(QPainter& painter, const RadarScene& scene);
+    void drawLaserLock(QPainter& painter, const RadarScene& scene);
+    void drawHeatmap(QPainter& painter, const RadarScene& scene);
+    void drawDroneSprites(QPainter& painter, const RadarScene& scene);
+    void drawDroneLabels(QPainter& painter, const RadarScene& scene);
+    void drawStrikeHighlight(QPainter& painter, const RadarScene& scene);
+    void drawStrikeEffects(QPainter& painter, const RadarScene& scene);
+
+    double m_scaleFactor = 1.0;
+    QImage m_sweepTexture;      // 扫描拖影纹理（扫描线朝北），按半径和像素比缓存
+
+    // 批量绘制缓冲：按样式分组，每帧清空但保留容量
+    QHash<quint64, QVector<QLineF>> m_trailLineBatches;   // (颜色, 透明度档) -> 轨迹线段
+    QHash<quint64, QVector<QPointF>> m_trailPointBatches; // (颜色, 透明度档) -> 轨迹圆点
+    QHash<QRgb, QVector<QLineF>> m_trailLinkBatches;      // 颜色 -> 末端连接线
+    QHash<quint64, QPainterPath> m_droneBodyBatches;      // (颜色, 是否外推) -> 三角形图标
+    QHash<QRgb, QVector<QPointF>> m_droneSpriteBatches;   // 颜色 -> 点精灵
+};
+
+// 后台渲染器：运行在独立线程中，把场景光栅化到后缓冲，完成后与前缓冲交换
+// GUI线程只在paintEvent中贴前缓冲
+class RadarRenderWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RadarRenderWorker(QObject *parent = nullptr);
+
+    // GUI线程调用：把最近完成的一帧贴到painter当前坐标系的原点
+    void presentFrame(QPainter& painter);
+
+    qint64 getLastRenderTime() const { return m_lastRenderTimeUs.load(std::memory_order_relaxed); }  // 微秒
+
+public slots:
+    // 在渲染线程中执行
+    void renderScene(const RadarScene& scene);
+
+signals:
+    void frameRendered();
+
+private:
+    RadarSceneRenderer m_renderer;
+    QImage m_backImage;     // 仅渲染线程访问
+    QImage m_frontImage;    // 受m_frontMutex保护
+    QMutex m_frontMutex;
+    std::atomic<qint64> m_lastRenderTimeUs;
+};
+
+#endif // RADARSCENERENDERER_H
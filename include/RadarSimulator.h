@@ -9,24 +9,11 @@
 #include <QList>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include <QThread>
 #include "DroneManager.h"
 #include "Drone.h"
-
-struct RadarDetection {
-    int droneId;
-    QPointF position;
-    QPointF velocity;
-    qint64 detectionTime;
-    double distance;
-    double azimuth; // 方位角
-    
-    // 新轨迹系统字段
-    TrajectoryType trajectoryType = TrajectoryType::Linear;
-    SpeedType speedType = SpeedType::Constant;
-    double currentDirection = 0.0; // 当前方向角度（弧度）
-    double currentSpeed = 0.0;     // 新轨迹系统的实际速度（米/秒）
-    bool useNewTrajectory = false; // 是否使用新轨迹系统
-};
+#include "RadarDetection.h"
+#include "RadarWorker.h"
 
 class RadarSimulator : public QObject
 {
@@ -36,23 +23,28 @@ public:
     explicit RadarSimulator(DroneManager* droneManager, QObject *parent = nullptr);
     ~RadarSimulator();
     
-    // 雷达配置
-    void setRadarCenter(QPointF center) { m_radarCenter = center; }
-    void setRadarRadius(double radius) { m_radarRadius = radius; }
-    void setScanInterval(int intervalMs) { m_scanInterval = intervalMs; }
+    // 雷达配置（参数同步到雷达线程）
+    void setRadarCenter(QPointF center);
+    void setRadarRadius(double radius);
+    void setScanInterval(int intervalMs);
+    void setScanMode(RadarScanMode mode, int sectorCount = 12);
     
     QPointF getRadarCenter() const { return m_radarCenter; }
     double getRadarRadius() const { return m_radarRadius; }
     int getScanInterval() const { return m_scanInterval; }
+    RadarScanMode getScanMode() const { return m_scanMode; }
+    int getSectorCount() const { return m_sectorCount; }
     
     // 雷达控制
     void startRadar();
     void stopRadar();
-    bool isRunning() const { return m_scanTimer->isActive(); }
+    bool isRunning() const { return m_scanning; }
     
     // 网络UDP服务器
     void startServer(quint16 port = 12345);
     void stopServer();
+    // 最终一致：套接字在雷达线程中绑定/关闭，本值只在排队的serverStateChanged到达后才更新，
+    // startServer/stopServer返回后立刻读取得到的仍是旧状态；界面应响应serverStateChanged信号
     bool isServerRunning() const;
     void addClient(const QHostAddress& address, quint16 port);
     
@@ -69,30 +61,35 @@ public:
 
 signals:
     void radarScanCompleted(QList<RadarDetection> detections);
+    void sectorScanned(int sectorIndex, double beamStart, double beamWidth, QList<RadarDetection> detections);
     void clientAdded(QString clientAddress);
     void dataSent(QByteArray data);
+    void serverStateChanged(bool running);
 
 private slots:
-    void performRadarScan();
+    void onWorkerScanCompleted(QList<RadarDetection> detections);
     void handleConfigMessage();
 
 private:
-    void sendDataToClients(const QByteArray& data);
     void sendConfigResponse(const QJsonObject& response, const QHostAddress& address, quint16 port);
-    QByteArray serializeDetections(const QList<RadarDetection>& detections);
-    double calculateDistance(QPointF pos1, QPointF pos2);
-    double calculateAzimuth(QPointF center, QPointF target);
+    void syncRadarParameters();
     
     DroneManager* m_droneManager;
-    QTimer* m_scanTimer;
-    QUdpSocket* m_udpSocket;
     QUdpSocket* m_configSocket;
     QList<QPair<QHostAddress, quint16>> m_clients;
     
-    // 雷达参数
+    // 雷达线程：扫描、序列化和数据发送都在该线程中完成，不受界面负载影响
+    QThread* m_workerThread;
+    RadarWorker* m_worker;
+    bool m_scanning;
+    bool m_serverRunning;
+    
+    // 雷达参数（GUI线程副本，修改后同步到工作线程）
     QPointF m_radarCenter;
     double m_radarRadius;
     int m_scanInterval;
+    RadarScanMode m_scanMode;
+    int m_sectorCount;
     
     // 检测结果
     QList<RadarDetection> m_latestDetections;
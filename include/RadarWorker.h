@@ -0,0 +1,110 @@
+#ifndef RADARWORKER_H
+#define RADARWORKER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <QPointF>
+#include <QList>
+#include <QPair>
+#include <QVector>
+#include <QSet>
+#include "DroneManager.h"
+#include "RadarDetection.h"
+
+class MetricCounter;
+class MetricTimer;
+
+// 雷达扫描模式
+enum class RadarScanMode {
+    FullScan = 0,   // 每次扫描评估全部无人机
+    SectorScan = 1  // 旋转波束：每次只评估当前扇区内的无人机
+};
+
+// 雷达工作者：运行在独立线程中，负责定时扫描、序列化和UDP发送
+// 只通过DroneManager的快照读取无人机状态，不触碰任何GUI线程对象
+class RadarWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RadarWorker(DroneManager* droneManager, QObject *parent = nullptr);
+    ~RadarWorker();
+
+    // 对一个快照执行扫描（纯函数，可在任意线程调用）
+    static QList<RadarDetection> scanSnapshot(const DroneSnapshot& snapshot, QPointF radarCenter,
+                                              double radarRadius, qint64 detectionTime);
+    // 单个目标的覆盖判定与检测结果填充，供多站雷达网络复用
+    static bool detectState(const DroneState& state, QPointF radarCenter, double radarRadius,
+                            qint64 detectionTime, RadarDetection& detection);
+    static QByteArray serializeDetections(const QList<RadarDetection>& detections);
+    static QByteArray serializeSectorFrame(const QList<RadarDetection>& detections, double beamStart,
+                                           double beamWidth, int sectorIndex, int sectorCount);
+
+public slots:
+    // 以下槽函数均应通过排队调用在工作线程中执行
+    void initialize();
+    void shutdown();
+    void startScanning(int intervalMs);
+    void stopScanning();
+    void setScanInterval(int intervalMs);
+    void setRadarParameters(QPointF center, double radius);
+    void setScanMode(RadarScanMode mode, int sectorCount);
+    void bindServer(quint16 port);
+    void closeServer();
+    void addClient(const QHostAddress& address, quint16 port);
+
+signals:
+    void scanCompleted(QList<RadarDetection> detections);
+    // 扇区模式下每个节拍发出的局部帧（波束角为弧度，0为北，顺时针）
+    void sectorScanned(int sectorIndex, double beamStart, double beamWidth, QList<RadarDetection> detections);
+    void dataSent(QByteArray data);
+    void serverStateChanged(bool bound);
+
+    // 扇区模式的一个节拍：扫描当前扇区并把波束推进到下一扇区。
+    // 扫描定时器调用；诊断工具也可以在任意线程中用构造的快照同步驱动
+    void performSectorScan(const DroneSnapshot& snapshot, qint64 detectionTime);
+
+private slots:
+    void performRadarScan();
+
+private:
+    void rebuildAzimuthIndex(const DroneSnapshot& snapshot);
+    void indexNewDrones(const DroneSnapshot& snapshot);
+    void indexDrone(const DroneState& state);
+    int sectorOf(QPointF position) const;
+    void sendDataToClients(const QByteArray& data);
+
+    DroneManager* m_droneManager;   // 仅用于getSnapshot()，该方法线程安全
+    QTimer* m_scanTimer;
+    QUdpSocket* m_udpSocket;
+    QList<QPair<QHostAddress, quint16>> m_clients;
+    
+    // 每个客户端的发送计数，与m_clients下标一一对应
+    struct ClientMetrics {
+        MetricCounter* datagrams;
+        MetricCounter* bytes;
+        MetricCounter* errors;
+    };
+    QVector<ClientMetrics> m_clientMetrics;
+    MetricTimer* m_scanDuration;
+
+    // 工作线程侧的雷达参数副本
+    QPointF m_radarCenter;
+    double m_radarRadius;
+    int m_scanInterval;
+    
+    // 旋转波束扫描：每转一圈重建一次方位角分桶索引，每个节拍只检查当前扇区及相邻扇区的桶；
+    // 一圈内方位角可能变化超过一个扇区的目标（靠近雷达或速度很快）不进桶，每个节拍都检查
+    RadarScanMode m_scanMode;
+    int m_sectorCount;
+    int m_currentSector;
+    QVector<QVector<int>> m_azimuthBuckets;       // 扇区 -> 无人机ID
+    QVector<int> m_fastMovers;                    // 每个节拍都检查的无人机ID
+    QSet<int> m_indexedIds;                       // 已进入索引（桶或m_fastMovers）的无人机ID
+    quint64 m_indexedSequence;                    // 索引最近一次同步到的快照序号
+    QVector<QList<RadarDetection>> m_sectorPictures; // 各扇区最近一次检测结果，整圈结束时合并发布
+};
+
+#endif // RADARWORKER_H
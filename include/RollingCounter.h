@@ -0,0 +1,72 @@
+#ifndef ROLLINGCOUNTER_H
+#define ROLLINGCOUNTER_H
+
+#include <QVector>
+#include <deque>
+
+// 滑动窗口聚合：窗口切成固定数量的时间片，计数和求和随时间片过期增量扣除，
+// 最大值用单调递减队列维护；记录和查询均为均摊O(1)
+// 窗口以时间片为粒度滑动，边界误差不超过一个时间片
+class RollingCounter
+{
+public:
+    explicit RollingCounter(qint64 windowMs = 60000, int slices = 10);
+
+    qint64 getWindowMs() const { return m_sliceMs * m_slices.size(); }
+
+    void add(qint64 time, double value = 0.0);
+    void clear();
+
+    // 查询前把窗口推进到now，丢弃过期时间片
+    void advance(qint64 now);
+
+    qint64 count() const { return m_count; }
+    double sum() const { return m_sum; }
+    double max() const { return m_maxQueue.empty() ? 0.0 : m_maxQueue.front().value; }
+    double ratePerSecond() const { return m_count * 1000.0 / getWindowMs(); }
+
+private:
+    struct Slice {
+        qint64 id = -1;     // 时间片编号 = 时间 / 时间片长度
+        qint64 count = 0;
+        double sum = 0.0;
+    };
+    struct MaxEntry {
+        qint64 sliceId;
+        double value;
+    };
+
+    void expireBefore(qint64 firstValidSlice);
+
+    qint64 m_sliceMs;
+    QVector<Slice> m_slices;
+    qint64 m_newestSlice;
+    qint64 m_count;
+    double m_sum;
+    std::deque<MaxEntry> m_maxQueue;   // 值单调递减，队首为窗口最大值
+};
+
+// 常用的实时统计窗口
+enum class RollingWindow {
+    OneSecond,
+    TenSeconds,
+    OneMinute,
+    TenMinutes
+};
+
+// 一个事件来源在各窗口上的聚合
+class RollingStats
+{
+public:
+    RollingStats();
+
+    void add(qint64 time, double value);
+    void clear();
+
+    RollingCounter& window(RollingWindow window) { return m_windows[int(window)]; }
+
+private:
+    RollingCounter m_windows[4];
+};
+
+#endif // ROLLINGCOUNTER_H
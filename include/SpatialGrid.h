@@ -0,0 +1,86 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <QPointF>
+#include <QHash>
+#include <QVector>
+
+// 均匀网格空间索引：按坐标把条目分到固定大小的网格单元中，
+// 范围查询只访问与查询圆相交的单元，适合每帧重建、多次查询的场景
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(double cellSize = 100.0);
+
+    void setCellSize(double cellSize);
+    double getCellSize() const { return m_cellSize; }
+
+    void clear();
+    void insert(int index, QPointF position);
+    int size() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+
+    // 访问距离center不超过radius的所有条目：visitor(int index, QPointF position)
+    template<typename Visitor>
+    void forEachInRadius(QPointF center, double radius, Visitor visitor) const;
+
+    // 返回radius范围内最近条目的index，没有则返回-1
+    int findNearest(QPointF center, double radius) const;
+
+private:
+    struct Entry {
+        int index;
+        QPointF position;
+    };
+
+    int cellCoord(double value) const;
+    static quint64 cellKey(int cellX, int cellY);
+
+    double m_cellSize;
+    QHash<quint64, QVector<Entry>> m_cells;
+    int m_count;
+};
+
+template<typename Visitor>
+void SpatialGrid::forEachInRadius(QPointF center, double radius, Visitor visitor) const
+{
+    if (m_count == 0 || radius < 0) {
+        return;
+    }
+
+    const double radiusSquared = radius * radius;
+    auto visitCell = [&](const QVector<Entry>& entries) {
+        for (const Entry& entry : entries) {
+            double dx = entry.position.x() - center.x();
+            double dy = entry.position.y() - center.y();
+            if (dx * dx + dy * dy <= radiusSquared) {
+                visitor(entry.index, entry.position);
+            }
+        }
+    };
+
+    const int minX = cellCoord(center.x() - radius);
+    const int maxX = cellCoord(center.x() + radius);
+    const int minY = cellCoord(center.y() - radius);
+    const int maxY = cellCoord(center.y() + radius);
+
+    // 查询范围覆盖的单元数多于已占用单元时，直接遍历已占用单元更快
+    const qint64 coveredCells = qint64(maxX - minX + 1) * qint64(maxY - minY + 1);
+    if (coveredCells > m_cells.size()) {
+        for (auto it = m_cells.constBegin(); it != m_cells.constEnd(); ++it) {
+            visitCell(it.value());
+        }
+        return;
+    }
+
+    for (int cellY = minY; cellY <= maxY; ++cellY) {
+        for (int cellX = minX; cellX <= maxX; ++cellX) {
+            auto it = m_cells.constFind(cellKey(cellX, cellY));
+            if (it != m_cells.constEnd()) {
+                visitCell(it.value());
+            }
+        }
+    }
+}
+
+#endif // SPATIALGRID_H
@@ -0,0 +1,37 @@
+#ifndef STATISTICSEVENT_H
+#define STATISTICSEVENT_H
+
+#include <QPointF>
+#include <QString>
+#include <QDateTime>
+
+// 统计事件类型
+enum class EventType {
+    DroneSpawned,
+    DroneDestroyed,
+    DroneEscaped,        // 新增：无人机逃脱（出界）
+    StrikeExecuted,
+    InterceptExecuted,
+    HighThreatDetected
+};
+
+const int EventTypeCount = int(EventType::HighThreatDetected) + 1;
+
+// 统计事件记录（按值传递的视图；存储端为列式布局，见EventStore）
+struct StatisticsEvent {
+    qint64 timestamp;
+    EventType type;
+    int droneId;
+    QPointF position;
+    double value; // 威胁值、爆炸半径等
+    
+    StatisticsEvent(EventType t = EventType::DroneSpawned, int id = -1, QPointF pos = QPointF())
+        : timestamp(QDateTime::currentMSecsSinceEpoch()), type(t), droneId(id), position(pos), value(0.0) {}
+    StatisticsEvent(qint64 time, EventType t, int id, QPointF pos, double v)
+        : timestamp(time), type(t), droneId(id), position(pos), value(v) {}
+    
+    // 说明文字由类型、ID和数值按需生成，不随事件存储
+    QString details() const;
+};
+
+#endif // STATISTICSEVENT_H
@@ -0,0 +1,51 @@
+#ifndef STATISTICSEXPORTER_H
+#define STATISTICSEXPORTER_H
+
+#include <QObject>
+#include <QIODevice>
+#include <QString>
+#include <functional>
+#include "EventStore.h"
+
+// 导出所需的数据快照：EventStore按块隐式共享，复制时不复制事件本身
+struct StatisticsExportSnapshot {
+    EventStore events;
+    qint64 sessionStartTime = 0;
+    int totalDronesSpawned = 0;
+    int totalDronesDestroyed = 0;
+    int totalStrikesExecuted = 0;
+    int totalInterceptsExecuted = 0;
+    double totalThreatNeutralized = 0.0;
+    double defenseEfficiency = 0.0;
+};
+
+// 统计数据导出器：逐条事件格式化到缓冲区，满一块写一次文件，内存占用与会话长度无关
+// 静态函数可直接同步调用；exportFiles()运行在导出线程中并报告进度
+class StatisticsExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StatisticsExporter(QObject *parent = nullptr);
+
+    // 进度回调参数：已写事件数，总事件数
+    using ProgressCallback = std::function<void(int, int)>;
+
+    static bool writeJson(QIODevice& device, const StatisticsExportSnapshot& snapshot,
+                          const ProgressCallback& progress = ProgressCallback());
+    static bool writeCsv(QIODevice& device, const StatisticsExportSnapshot& snapshot,
+                         const ProgressCallback& progress = ProgressCallback());
+    static const char* eventTypeName(EventType type);
+
+public slots:
+    // 在导出线程中执行；文件名为空则跳过对应格式
+    void exportFiles(const StatisticsExportSnapshot& snapshot,
+                     const QString& jsonFilename, const QString& csvFilename);
+
+signals:
+    // percent为两个文件合计的进度（0~100）
+    void exportProgress(int percent);
+    void exportFinished(bool success, const QString& message);
+};
+
+#endif // STATISTICSEXPORTER_H
@@ -1,111 +1,206 @@
-#ifndef STATISTICSMANAGER_H
-#define STATISTICSMANAGER_H
-
-#include <QObject>
-#include <QTimer>
-#include <QList>
-#include <QPointF>
-#include <QDateTime>
-#include <QJsonObject>
-#include <QJsonDocument>
-#include <QJsonArray>
-#include "Drone.h"
-
-// 统计事件类型
-enum class EventType {
-    DroneSpawned,
-    DroneDestroyed,
-    DroneEscaped,        // 新增：无人机逃脱（出界）
-    StrikeExecuted,
-    InterceptExecuted,
-    HighThreatDetected
-};
-
-// 统计事件记录
-struct StatisticsEvent {
-    qint64 timestamp;
-    EventType type;
-    int droneId;
-    QPointF position;
-    double value; // 威胁值、爆炸半径等
-    QString details;
-    
-    StatisticsEvent(EventType t, int id = -1, QPointF pos = QPointF(), const QString& det = "")
-        : timestamp(QDateTime::currentMSecsSinceEpoch()), type(t), droneId(id), position(pos), details(det) {}
-};
-
-// 统计数据结构
-struct DefenseStatistics {
-    int totalDronesSpawned = 0;
-    int totalDronesDestroyed = 0;
-    int totalDronesEscaped = 0;  // 新增：逃脱无人机数量
-    int totalStrikesExecuted = 0;
-    int totalInterceptsExecuted = 0;
-    double totalThreatNeutralized = 0.0;
-    double averageResponseTime = 0.0;
-    double defenseEfficiency = 0.0; // 摧毁率
-    
-    // 按无人机类型统计（已废弃，现在统一类型）
-    // int typeADestroyed = 0;
-    // int typeBDestroyed = 0;
-    // int typeCDestroyed = 0;
-    
-    // 威胁等级统计
-    int highThreatEvents = 0;
-    double maxThreatLevel = 0.0;
-};
-
-class StatisticsManager : public QObject
-{
-    Q_OBJECT
-
-public:
-    explicit StatisticsManager(QObject *parent = nullptr);
-    
-    // 事件记录
-    void recordDroneSpawned(int droneId, DroneType type, QPointF position);
-    void recordDroneDestroyed(int droneId, DroneType type, QPointF position, double threatValue);
-    void recordDroneEscaped(int droneId, DroneType type, QPointF position);  // 新增：记录逃脱
-    void recordStrikeExecuted(QPointF position, double radius, int dronesDestroyed);
-    void recordInterceptExecuted(int droneId, QPointF interceptPoint, double threatValue);
-    void recordHighThreatDetected(int droneId, double threatLevel);
-    
-    // 统计数据获取
-    DefenseStatistics getCurrentStatistics() const;
-    QList<StatisticsEvent> getRecentEvents(int minutes = 10) const;
-    QList<StatisticsEvent> getEventsByType(EventType type) const;
-    
-    // 数据导出
-    QString generateReport() const;
-    bool exportToJson(const QString& filename) const;
-    bool exportToCsv(const QString& filename) const;
-    
-    // 实时分析
-    double calculateCurrentThreatLevel() const;
-    double getDefenseEfficiency() const;
-    QString getBestPerformanceMetrics() const;
-    
-    // 数据清理
-    void clearOldEvents(int daysOld = 7);
-    void resetStatistics();
-
-signals:
-    void statisticsUpdated(const DefenseStatistics& stats);
-    void reportGenerated(const QString& report);
-    void highActivityDetected(int eventsPerMinute);
-
-private slots:
-    void updateRealTimeStats();
-
-private:
-    QList<StatisticsEvent> m_events;
-    DefenseStatistics m_statistics;
-    QTimer* m_updateTimer;
-    qint64 m_sessionStartTime;
-    
-    void updateStatistics();
-    QJsonObject eventToJson(const StatisticsEvent& event) const;
-    StatisticsEvent jsonToEvent(const QJsonObject& json) const;
-};
-
-#endif // STATISTICSMANAGER_H 
+#ifndef STATISTICSMANAGER_H
+#define STATISTICSMANAGER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QThread>
+#include <QList>
+#include <QHash>
+#include <QPointF>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include "Drone.h"
+#include "StatisticsEvent.h"
+#include "EventStore.h"
+#include "RollingCounter.h"
+#include "StatisticsExporter.h"
+#include "EventJournal.h"
+#include "LatencyHistogram.h"
+#include "MpscQueue.h"
+#include <atomic>
+
+// 统计数据结构
+struct DefenseStatistics {
+    int totalDronesSpawned = 0;
+    int totalDronesDestroyed = 0;
+    int totalDronesEscaped = 0;  // 新增：逃脱无人机数量
+    int totalStrikesExecuted = 0;
+    int totalInterceptsExecuted = 0;
+    double totalThreatNeutralized = 0.0;
+    double averageResponseTime = 0.0;
+    double defenseEfficiency = 0.0; // 摧毁率
+    
+    // 按无人机类型统计（已废弃，现在统一类型）
+    // int typeADestroyed = 0;
+    // int typeBDestroyed = 0;
+    // int typeCDestroyed = 0;
+    
+    // 威胁等级统计
+    int highThreatEvents = 0;
+    double maxThreatLevel = 0.0;
+};
+
+// 单架无人机的生命周期时间点（毫秒时间戳，0表示尚未发生），随事件到达逐步填写
+// 摧毁或逃脱时把派生的响应时间、存活时长计入累计量后即删除，表中只保留仍在场的无人机
+struct DroneLifecycle {
+    qint64 spawnTime = 0;
+    qint64 firstDetectionTime = 0;
+    qint64 firstHighThreatTime = 0;
+    qint64 engagedTime = 0;       // 首次被激光锁定
+    qint64 lastEventTime = 0;     // 最近一次有该无人机的记录，按时龄淘汰时使用
+};
+
+// 延迟分布的种类
+enum class LatencyMetric {
+    TimeToDetection,        // 生成 -> 首次探测
+    DetectionToEngagement,  // 首次探测 -> 锁定
+    EngagementToKill,       // 锁定 -> 摧毁
+    ScanToDisplay           // 雷达扫描 -> 显示端应用该帧
+};
+
+class StatisticsManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StatisticsManager(QObject *parent = nullptr);
+    ~StatisticsManager();
+    
+    // 事件记录：任意线程均可调用，记录进入无锁队列，由所属线程批量汇总
+    void recordDroneSpawned(int droneId, DroneType type, QPointF position);
+    void recordDroneDestroyed(int droneId, DroneType type, QPointF position, double threatValue);
+    void recordDroneEscaped(int droneId, DroneType type, QPointF position);  // 新增：记录逃脱
+    void recordStrikeExecuted(QPointF position, double radius, int dronesDestroyed);
+    void recordInterceptExecuted(int droneId, QPointF interceptPoint, double threatValue);
+    void recordHighThreatDetected(int droneId, double threatLevel);
+    void recordDroneDetected(int droneId);  // 首次进入雷达探测范围
+    void recordTargetEngaged(int droneId);  // 激光锁定目标，只记录首次
+    void recordDisplayLatency(qint64 latencyMs);
+    
+    // 立即汇总队列中的记录（只能在所属线程调用）
+    void flushIntake() { drainIntake(); }
+    quint64 getDroppedRecords() const { return m_droppedRecords.load(std::memory_order_relaxed); }
+    
+    // 统计数据获取
+    DefenseStatistics getCurrentStatistics() const;
+    QList<StatisticsEvent> getRecentEvents(int minutes = 10) const;
+    QList<StatisticsEvent> getEventsByType(EventType type) const;
+    
+    // 数据导出
+    QString generateReport() const;
+    bool exportToJson(const QString& filename) const;
+    bool exportToCsv(const QString& filename) const;
+    // 后台导出：在导出线程中流式写文件，通过exportProgress/exportFinished报告
+    void exportDataAsync(const QString& jsonFilename, const QString& csvFilename);
+    
+    // 二进制事件日志：打开后每个record*调用都追加一条定长记录
+    bool openJournal(const QString& filename);
+    void closeJournal();
+    QString getJournalFileName() const { return m_journal->isOpen() ? m_journal->fileName() : QString(); }
+    
+    // 滑动窗口聚合（增量维护，读取时只推进窗口）
+    struct RollingSnapshot {
+        qint64 count = 0;
+        double sum = 0.0;
+        double max = 0.0;
+        double ratePerSecond = 0.0;
+    };
+    RollingSnapshot getRollingStats(EventType type, RollingWindow window) const;
+    RollingSnapshot getTotalRollingStats(RollingWindow window) const;
+    
+    // 生命周期与响应时间（增量维护，O(1)查询）；已摧毁或逃脱的无人机返回空的生命周期
+    DroneLifecycle getDroneLifecycle(int droneId) const { return m_lifecycles.value(droneId); }
+    double getAverageResponseTime() const;       // 首次高威胁 -> 摧毁，毫秒
+    double getAverageDetectionLatency() const;   // 生成 -> 首次探测，毫秒
+    
+    // 延迟分布（毫秒）：返回的是快照，可跨会话或多个实例合并
+    LatencyHistogram getLatencyHistogram(LatencyMetric metric) const { return m_latency[int(metric)]; }
+    
+    // 实时分析
+    double calculateCurrentThreatLevel() const;
+    double getDefenseEfficiency() const;
+    QString getBestPerformanceMetrics() const;
+    
+    // 数据清理
+    void clearOldEvents(int daysOld = 7);
+    void resetStatistics();
+
+signals:
+    void statisticsUpdated(const DefenseStatistics& stats);
+    void reportGenerated(const QString& report);
+    void highActivityDetected(int eventsPerMinute);
+    void exportProgress(int percent);
+    void exportFinished(bool success, const QString& message);
+
+private slots:
+    void updateRealTimeStats();
+
+private:
+    // 入队的原始记录：定长、无堆分配，汇总时才生成事件
+    struct IntakeRecord {
+        enum Kind : quint8 {
+            DroneSpawned,
+            DroneDestroyed,
+            DroneEscaped,
+            StrikeExecuted,
+            InterceptExecuted,
+            HighThreatDetected,
+            DroneDetected,
+            TargetEngaged,
+            DisplayLatency
+        };
+        Kind kind = DroneSpawned;
+        int droneId = -1;
+        qint64 timestamp = 0;
+        QPointF position;
+        double value = 0.0;     // 威胁值、摧毁数量或延迟毫秒
+    };
+    
+    void pushRecord(IntakeRecord::Kind kind, int droneId, QPointF position, double value = 0.0);
+    void drainIntake();
+    void applyRecord(const IntakeRecord& record);
+    DroneLifecycle& touchLifecycle(int droneId, qint64 timestamp);
+    void pruneLifecycles(qint64 olderThan);
+    
+    MpscQueue<IntakeRecord> m_intake;
+    std::atomic<bool> m_drainScheduled;
+    std::atomic<quint64> m_droppedRecords;     // 队列满时其他线程丢弃的记录数
+    
+    EventStore m_events;    // 按秒分桶的列式事件存储，近期窗口查询只扫描相关的桶
+    
+    // 每种事件类型一组滑动窗口聚合，另有一组汇总全部事件
+    mutable RollingStats m_rollingByType[EventTypeCount];
+    mutable RollingStats m_rollingTotal;
+    
+    // 按无人机ID索引的生命周期，以及由它派生的响应时间累计量
+    // 没有收到摧毁/逃脱事件的条目（如结束后才到达的迟到记录）超过保留时长未更新也会被淘汰
+    static const qint64 LifecycleRetentionMs = 10 * 60 * 1000;
+    QHash<int, DroneLifecycle> m_lifecycles;
+    double m_responseTimeSum;       // 首次高威胁 -> 摧毁
+    int m_responsePairs;
+    double m_validResponseTimeSum;  // 同上，仅60秒内的配对
+    int m_validResponsePairs;
+    double m_lifetimeSum;           // 生成 -> 摧毁
+    
+    static const int LatencyMetricCount = int(LatencyMetric::ScanToDisplay) + 1;
+    LatencyHistogram m_latency[LatencyMetricCount];
+    DefenseStatistics m_statistics;
+    QTimer* m_updateTimer;
+    QThread* m_exportThread;
+    StatisticsExporter* m_exporter;
+    EventJournal* m_journal;
+    qint64 m_sessionStartTime;
+    
+    void updateStatistics();
+    void publishMetrics();
+    void publishLatencyMetrics();
+    StatisticsExportSnapshot exportSnapshot() const;
+    void appendEvent(const StatisticsEvent& event);
+    static RollingSnapshot snapshotOf(RollingCounter& counter);
+    QJsonObject eventToJson(const StatisticsEvent& event) const;
+    StatisticsEvent jsonToEvent(const QJsonObject& json) const;
+};
+
+#endif // STATISTICSMANAGER_H 
@@ -0,0 +1,110 @@
+#ifndef TRACING_H
+#define TRACING_H
+
+// 作用域追踪：RADAR_TRACE_SCOPE("名称") 记录所在作用域的起止时间。
+// 只有定义了RADAR_ENABLE_TRACING（qmake CONFIG+=radar_tracing）才会编译进来，
+// 否则宏展开为空语句，没有任何运行时开销
+
+#ifdef RADAR_ENABLE_TRACING
+
+#include <QString>
+#include <QMutex>
+#include <QVector>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// 一个已结束的区间；name必须是字符串字面量等静态存储的字符串
+struct TraceSpan {
+    const char* name;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+// 单个线程的环形缓冲区：只有所属线程写入，写满后覆盖最旧的区间
+class TraceBuffer
+{
+public:
+    TraceBuffer(int threadIndex, const QString& threadName, int capacity);
+
+    void append(const char* name, qint64 startNs, qint64 durationNs)
+    {
+        quint64 index = m_written.load(std::memory_order_relaxed);
+        m_spans[int(index % m_spans.size())] = { name, startNs, durationNs };
+        m_written.store(index + 1, std::memory_order_release);
+    }
+
+    int threadIndex() const { return m_threadIndex; }
+    QString threadName() const { return m_threadName; }
+    // 复制当前保留的区间（按时间顺序）；写入线程可能同时在覆盖最旧的槽位，因此留出余量不读
+    QVector<TraceSpan> snapshot() const;
+
+private:
+    int m_threadIndex;
+    QString m_threadName;
+    QVector<TraceSpan> m_spans;
+    std::atomic<quint64> m_written;
+};
+
+// 追踪器：管理各线程的缓冲区，按需导出Chrome Trace Event JSON（chrome://tracing、Perfetto可直接打开）
+class Tracer
+{
+public:
+    static Tracer& instance();
+
+    // 时间基准为追踪器创建时刻
+    qint64 nowNs() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - m_epoch).count();
+    }
+
+    // 当前线程的缓冲区，首次调用时注册
+    TraceBuffer& threadBuffer();
+
+    void setBufferCapacity(int spans) { m_bufferCapacity = qMax(16, spans); }
+    bool writeChromeTrace(const QString& filename);
+
+private:
+    Tracer();
+
+    std::chrono::steady_clock::time_point m_epoch;
+    QMutex m_mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> m_buffers;   // 线程退出后数据仍保留
+    int m_bufferCapacity;
+};
+
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name)
+        : m_name(name)
+        , m_startNs(Tracer::instance().nowNs())
+    {
+    }
+    ~TraceScope()
+    {
+        Tracer& tracer = Tracer::instance();
+        tracer.threadBuffer().append(m_name, m_startNs, tracer.nowNs() - m_startNs);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    qint64 m_startNs;
+};
+
+#define RADAR_TRACE_CONCAT_IMPL(a, b) a##b
+#define RADAR_TRACE_CONCAT(a, b) RADAR_TRACE_CONCAT_IMPL(a, b)
+#define RADAR_TRACE_SCOPE(name) TraceScope RADAR_TRACE_CONCAT(radarTraceScope_, __LINE__)(name)
+
+#else
+
+#define RADAR_TRACE_SCOPE(name) do { } while (0)
+
+#endif // RADAR_ENABLE_TRACING
+
+#endif // TRACING_H
@@ -0,0 +1,63 @@
+#ifndef TRACKERBANK_H
+#define TRACKERBANK_H
+
+#include <QPointF>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include "RadarDetection.h"
+
+// 跟踪器组：为每条航迹维护一个alpha-beta滤波器
+// 状态按分量存放在连续数组中（结构数组转数组结构），一帧检测到达后对所有航迹批量更新
+class TrackerBank
+{
+public:
+    explicit TrackerBank(double alpha = 0.5, double beta = 0.2);
+
+    void setGains(double alpha, double beta);
+    double getAlpha() const { return m_alpha; }
+    double getBeta() const { return m_beta; }
+
+    // 用一帧检测更新滤波器：新目标自动建立航迹
+    void update(const QList<RadarDetection>& detections);
+
+    // 查询滤波结果
+    bool contains(int trackId) const { return m_slotById.contains(trackId); }
+    QPointF filteredPosition(int trackId) const;
+    QPointF filteredVelocity(int trackId) const;
+    qint64 lastMeasurementTime(int trackId) const;
+
+    // 漏扫时按滤波速度外推到指定时刻
+    QPointF predictPosition(int trackId, qint64 time) const;
+
+    // 删除超过外推时限仍未更新的航迹，返回被删除的ID
+    QList<int> removeStale(qint64 currentTime, qint64 coastTimeoutMs);
+    void remove(int trackId);
+    void clear();
+    int size() const { return m_ids.size(); }
+
+private:
+    int createTrack(const RadarDetection& detection);
+    void removeSlot(int slot);
+
+    double m_alpha;
+    double m_beta;
+
+    // 滤波状态（下标即槽位）
+    QVector<int> m_ids;
+    QVector<double> m_x;
+    QVector<double> m_y;
+    QVector<double> m_vx;
+    QVector<double> m_vy;
+    QVector<qint64> m_time;
+
+    // 本帧量测，与状态数组同下标
+    QVector<double> m_measX;
+    QVector<double> m_measY;
+    QVector<qint64> m_measTime;
+    QVector<quint8> m_hasMeasurement;
+
+    QHash<int, int> m_slotById;
+};
+
+#endif // TRACKERBANK_H
@@ -0,0 +1,49 @@
+#ifndef TRAILARENA_H
+#define TRAILARENA_H
+
+#include <QPointF>
+#include <QVector>
+
+struct TrailPoint {
+    QPointF position;
+    qint64 time;    // 记录时间（毫秒），用于按时间淡出
+};
+
+// 轨迹内存池：所有航迹的轨迹点共用一块连续存储，每条航迹占一个固定容量的环形槽位
+// 稳态下追加和过期只移动头尾下标，不分配内存；单条轨迹内存上限为容量大小
+class TrailArena
+{
+public:
+    explicit TrailArena(int capacity = 15);
+
+    // 修改容量会清空所有轨迹，已分配的槽位保持有效
+    void setCapacity(int capacity);
+    int getCapacity() const { return m_capacity; }
+
+    int allocate();
+    void release(int slot);
+    void releaseAll();
+
+    void append(int slot, QPointF position, qint64 time);
+    void clear(int slot) { m_counts[slot] = 0; }
+    // 丢弃早于cutoffTime的轨迹点（从最老的一端）
+    void expire(int slot, qint64 cutoffTime);
+
+    int count(int slot) const { return m_counts[slot]; }
+    bool isEmpty(int slot) const { return slot < 0 || m_counts[slot] == 0; }
+    // i = 0 为最老的点
+    const TrailPoint& at(int slot, int i) const
+    {
+        return m_points[slot * m_capacity + (m_heads[slot] + i) % m_capacity];
+    }
+    const TrailPoint& last(int slot) const { return at(slot, m_counts[slot] - 1); }
+
+private:
+    int m_capacity;
+    QVector<TrailPoint> m_points;   // 槽位 * 容量
+    QVector<int> m_heads;           // 各槽位最老点的位置
+    QVector<int> m_counts;
+    QVector<int> m_freeSlots;
+};
+
+#endif // TRAILARENA_H
@@ -0,0 +1,107 @@
+#include "DensityHeatmap.h"
+#include <QColor>
+#include <QtMath>
+#include <cmath>
+
+DensityHeatmap::DensityHeatmap(int cellPixels, int decayTimeMs)
+    : m_cellPixels(qMax(1, cellPixels))
+    , m_decayTimeMs(qMax(1, decayTimeMs))
+    , m_resolution(0)
+    , m_worldRadius(0.0)
+    , m_depositWeight(1.0)
+    , m_empty(true)
+    , m_imageDirty(true)
+{
+    // 颜色表只生成一次：低密度为半透明绿色，高密度过渡到黄色和红色
+    m_palette.resize(256);
+    m_palette[0] = qPremultiply(qRgba(0, 0, 0, 0));
+    for (int i = 1; i < 256; ++i) {
+        double t = i / 255.0;
+        int red = int(255 * qMin(1.0, t * 2.0));
+        int green = int(255 * qMin(1.0, (1.0 - t) * 2.0));
+        int alpha = int(60 + 160 * t);
+        m_palette[i] = qPremultiply(qRgba(red, green, 0, alpha));
+    }
+}
+
+void DensityHeatmap::configure(double screenRadius, double worldRadius)
+{
+    int resolution = qBound(8, int(std::ceil(2.0 * screenRadius / m_cellPixels)), 512);
+    if (resolution == m_resolution && qFuzzyCompare(worldRadius, m_worldRadius)) {
+        return;
+    }
+
+    m_resolution = resolution;
+    m_worldRadius = worldRadius;
+    m_bins.fill(0.0f, m_resolution * m_resolution);
+    m_image = QImage(m_resolution, m_resolution, QImage::Format_ARGB32_Premultiplied);
+    m_empty = true;
+    m_imageDirty = true;
+}
+
+void DensityHeatmap::decay(qint64 elapsedMs)
+{
+    // 指数衰减与帧率无关：时间常数为m_decayTimeMs
+    double keep = std::exp(-double(qMax<qint64>(0, elapsedMs)) / m_decayTimeMs);
+    m_depositWeight = 1.0 - keep;
+    if (m_empty) {
+        return;
+    }
+
+    const float factor = float(keep);
+    for (float& value : m_bins) {
+        value *= factor;
+    }
+    m_imageDirty = true;
+}
+
+void DensityHeatmap::accumulate(QPointF worldPos)
+{
+    if (m_resolution == 0 || m_worldRadius <= 0.0) {
+        return;
+    }
+
+    double cellSize = 2.0 * m_worldRadius / m_resolution;
+    int cx = int(std::floor((worldPos.x() + m_worldRadius) / cellSize));
+    int cy = int(std::floor((worldPos.y() + m_worldRadius) / cellSize));
+    if (cx < 0 || cy < 0 || cx >= m_resolution || cy >= m_resolution) {
+        return;
+    }
+
+    m_bins[cy * m_resolution + cx] += float(m_depositWeight);
+    m_empty = false;
+    m_imageDirty = true;
+}
+
+void DensityHeatmap::clear()
+{
+    m_bins.fill(0.0f);
+    m_empty = true;
+    m_imageDirty = true;
+}
+
+const QImage& DensityHeatmap::image()
+{
+    if (!m_imageDirty || m_resolution == 0) {
+        return m_image;
+    }
+
+    float maxValue = 0.0f;
+    for (float value : m_bins) {
+        maxValue = qMax(maxValue, value);
+    }
+
+    // 对数映射，少数密集格不会把其余区域压成全透明
+    const double scale = (maxValue > 0.0f) ? 255.0 / std::log1p(double(maxValue)) : 0.0;
+    const float* bin = m_bins.constData();
+    for (int y = 0; y < m_resolution; ++y) {
+        QRgb* line = reinterpret_cast<QRgb*>(m_image.scanLine(y));
+        for (int x = 0; x < m_resolution; ++x, ++bin) {
+            int index = (*bin > 0.001f) ? qBound(1, int(std::log1p(double(*bin)) * scale), 255) : 0;
+            line[x] = m_palette[index];
+        }
+    }
+
+    m_imageDirty = false;
+    return m_image;
+}
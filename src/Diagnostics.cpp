@@ -0,0 +1,458 @@
+#include "Diagnostics.h"
+#include "RadarNetwork.h"
+#include "FusionEngine.h"
+#include "RadarWorker.h"
+#include "EventStore.h"
+#include "EventJournal.h"
+#include "RadarSceneRenderer.h"
+#include <QImage>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtMath>
+
+namespace {
+// 在以原点为中心、边长2*extent的正方形内随机生成count个目标
+QSharedPointer<DroneSnapshot> makeRandomSnapshot(int count, double extent, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    QSharedPointer<DroneSnapshot> snapshot(new DroneSnapshot);
+    snapshot->sequence = 1;
+    snapshot->drones.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        DroneState state;
+        state.id = i + 1;
+        state.position = QPointF((random.generateDouble() * 2.0 - 1.0) * extent,
+                                 (random.generateDouble() * 2.0 - 1.0) * extent);
+        state.velocity = QPointF(0, 0);
+        state.trajectoryType = TrajectoryType::Linear;
+        state.speedType = SpeedType::Constant;
+        state.currentDirection = 0.0;
+        state.currentSpeed = 0.0;
+        snapshot->indexById.insert(state.id, snapshot->drones.size());
+        snapshot->drones.append(state);
+    }
+    return snapshot;
+}
+
+// 以图像中心为原点，(x, y)附近3x3像素内是否有不透明的像素
+bool hasInkNear(const QImage& image, QPointF position)
+{
+    const int cx = image.width() / 2 + qRound(position.x());
+    const int cy = image.height() / 2 + qRound(position.y());
+    for (int y = cy - 1; y <= cy + 1; ++y) {
+        for (int x = cx - 1; x <= cx + 1; ++x) {
+            if (image.rect().contains(x, y) && qAlpha(image.pixel(x, y)) > 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+QSet<int> detectionIds(const QList<RadarDetection>& detections)
+{
+    QSet<int> ids;
+    for (const RadarDetection& detection : detections) {
+        ids.insert(detection.droneId);
+    }
+    return ids;
+}
+}
+
+int Diagnostics::run(const QStringList& arguments)
+{
+    QTextStream out(stdout);
+    if (arguments.contains("--self-test")) {
+        return runSelfTest(out);
+    }
+
+    int benchmark = arguments.indexOf("--benchmark-fusion");
+    if (benchmark >= 0) {
+        // 可选的位置参数依次为航迹数、雷达源数、周期数
+        int values[3] = { 5000, 3, 50 };
+        for (int i = 0; i < 3 && benchmark + 1 + i < arguments.size(); ++i) {
+            bool ok = false;
+            int value = arguments[benchmark + 1 + i].toInt(&ok);
+            if (!ok) {
+                break;
+            }
+            values[i] = qMax(1, value);
+        }
+        return runFusionBenchmark(out, values[0], values[1], values[2]);
+    }
+
+    int dump = arguments.indexOf("--dump-journal");
+    if (dump >= 0) {
+        if (dump + 1 >= arguments.size()) {
+            out << "usage: --dump-journal <file>" << Qt::endl;
+            return 2;
+        }
+        return dumpJournal(out, arguments[dump + 1]);
+    }
+    return -1;
+}
+
+int Diagnostics::runSelfTest(QTextStream& out)
+{
+    struct Check {
+        const char* name;
+        bool (*run)(QTextStream&);
+    };
+    const Check checks[] = {
+        { "network-coverage", &Diagnostics::checkNetworkCoverage },
+        { "fusion-association", &Diagnostics::checkFusionAssociation },
+        { "event-store-order", &Diagnostics::checkEventStoreOrder },
+        { "sector-crossing", &Diagnostics::checkSectorCrossing },
+        { "render-buffer-swap", &Diagnostics::checkRenderBufferSwap },
+        { "journal-round-trip", &Diagnostics::checkJournalRoundTrip },
+    };
+
+    int failures = 0;
+    for (const Check& check : checks) {
+        bool passed = check.run(out);
+        out << (passed ? "PASS " : "FAIL ") << check.name << Qt::endl;
+        if (!passed) {
+            ++failures;
+        }
+    }
+    out << failures << " of " << int(sizeof(checks) / sizeof(checks[0])) << " checks failed" << Qt::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+int Diagnostics::dumpJournal(QTextStream& out, const QString& filename)
+{
+    EventJournalReader reader;
+    if (!reader.open(filename)) {
+        out << "cannot read event journal " << filename << Qt::endl;
+        return 1;
+    }
+
+    out << "# session start " << reader.getSessionStartTime()
+        << ", " << reader.recordCount() << " records" << Qt::endl;
+    out << "# timestamp\ttype\tdrone\tx\ty\tvalue\tdetails" << Qt::endl;
+    reader.forEach([&out](const StatisticsEvent& event) {
+        out << event.timestamp << '\t' << int(event.type) << '\t' << event.droneId << '\t'
+            << event.position.x() << '\t' << event.position.y() << '\t' << event.value << '\t'
+            << event.details() << '\n';
+    });
+    out.flush();
+    return 0;
+}
+
+bool Diagnostics::checkNetworkCoverage(QTextStream& out)
+{
+    // 各站点经网格索引得到的覆盖结果必须与逐个目标调用RadarWorker::detectState一致
+    QSharedPointer<DroneSnapshot> snapshot = makeRandomSnapshot(5000, 1600.0, 28);
+
+    QVector<RadarSite> sites;
+    const double siteRadius[] = { 800.0, 600.0, 300.0, 1200.0 };
+    for (int i = 0; i < 4; ++i) {
+        RadarSite site;
+        site.siteId = i + 1;
+        double angle = i * M_PI / 2.0;
+        site.center = QPointF(qCos(angle), qSin(angle)) * 500.0;
+        site.radius = siteRadius[i];
+        sites.append(site);
+    }
+
+    RadarNetworkWorker worker(nullptr);
+    worker.setSites(sites);
+
+    bool passed = true;
+    for (const RadarSite& site : sites) {
+        QSet<int> indexed = detectionIds(worker.scanSite(*snapshot, site, 0));
+
+        QSet<int> expected;
+        RadarDetection detection;
+        for (const DroneState& state : snapshot->drones) {
+            if (RadarWorker::detectState(state, site.center, site.radius, 0, detection)) {
+                expected.insert(state.id);
+            }
+        }
+
+        if (indexed != expected) {
+            out << "  site " << site.siteId << ": indexed scan found " << indexed.size()
+                << " drones, detectState found " << expected.size() << Qt::endl;
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+int Diagnostics::runFusionBenchmark(QTextStream& out, int trackCount, int sourceCount, int cycles)
+{
+    FusionEngine::BenchmarkResult result = FusionEngine::runBenchmark(trackCount, sourceCount, cycles);
+    out << "fusion benchmark: " << result.trackCount << " tracks x " << result.sourceCount << " sources, "
+        << result.cycles << " cycles" << Qt::endl;
+    out << "  cycle time: avg " << result.averageCycleUs / 1000.0 << " ms, max " << result.maxCycleUs / 1000.0
+        << " ms, budget " << result.budgetUs / 1000.0 << " ms" << Qt::endl;
+    out << "  fused tracks: " << result.fusedTracks << " (" << result.multiSourceTracks
+        << " updated by every source)" << Qt::endl;
+    return result.averageCycleUs <= result.budgetUs ? 0 : 1;
+}
+
+bool Diagnostics::checkFusionAssociation(QTextStream& out)
+{
+    // 每个目标被全部雷达源观测：关联正确时航迹数等于目标数，且每条航迹都由全部雷达源更新
+    FusionEngine::BenchmarkResult result = FusionEngine::runBenchmark(500, 3, 10);
+    if (result.fusedTracks != result.trackCount || result.multiSourceTracks != result.trackCount) {
+        out << "  " << result.trackCount << " targets produced " << result.fusedTracks << " fused tracks, "
+            << result.multiSourceTracks << " fused from all sources" << Qt::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Diagnostics::checkEventStoreOrder(QTextStream& out)
+{
+    // 两段事件之间空闲超过环形窗口：归档后forEach仍按时间顺序，窗口查询与逐条过滤的结果一致
+    EventStore store(600);
+    QVector<qint64> timestamps;
+    for (qint64 second = 0; second < 1000; second += 3) {
+        timestamps.append(second * 1000 + 250);
+    }
+    for (qint64 second = 1700; second < 2600; second += 7) {
+        timestamps.append(second * 1000 + 500);
+    }
+    for (qint64 timestamp : timestamps) {
+        store.append(StatisticsEvent(timestamp, EventType::DroneSpawned, 1, QPointF(), 0.0));
+    }
+
+    bool passed = true;
+    qint64 previous = -1;
+    int visited = 0;
+    store.forEach([&](const StatisticsEvent& event) {
+        if (event.timestamp < previous) {
+            passed = false;
+        }
+        previous = event.timestamp;
+        ++visited;
+    });
+    if (!passed || visited != timestamps.size()) {
+        out << "  forEach visited " << visited << " of " << timestamps.size() << " events, time-ordered: "
+            << (passed ? "yes" : "no") << Qt::endl;
+        return false;
+    }
+
+    const qint64 windowStarts[] = { 0, 450000, 999000, 1500000, 1800000, 2500000 };
+    for (qint64 fromTime : windowStarts) {
+        int expected = 0;
+        for (qint64 timestamp : timestamps) {
+            expected += timestamp >= fromTime ? 1 : 0;
+        }
+        int found = 0;
+        store.forEachInWindow(fromTime, [&found](const StatisticsEvent&) { ++found; });
+        if (found != expected) {
+            out << "  window from " << fromTime << ": found " << found << ", expected " << expected << Qt::endl;
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+bool Diagnostics::checkSectorCrossing(QTextStream& out)
+{
+    // 逐节拍比较扇区扫描与逐个目标的波束判定：包括一圈内跨越两个以上扇区的近距离目标，
+    // 以及圈中出现、ID小于已有目标的新目标
+    const int sectorCount = 12;
+    const int intervalMs = 100;
+    RadarWorker worker(nullptr);
+    worker.setRadarParameters(QPointF(0, 0), 800.0);
+    worker.setScanInterval(intervalMs);
+    worker.setScanMode(RadarScanMode::SectorScan, sectorCount);
+
+    QList<RadarDetection> sectorDetections;
+    QObject::connect(&worker, &RadarWorker::sectorScanned,
+                     [&sectorDetections](int, double, double, QList<RadarDetection> detections) {
+        sectorDetections = detections;
+    });
+
+    QSharedPointer<DroneSnapshot> initial = makeRandomSnapshot(400, 700.0, 27);
+    QVector<DroneState> drones = initial->drones;
+    QRandomGenerator random(270);
+    for (DroneState& state : drones) {
+        double heading = random.generateDouble() * 2 * M_PI;
+        state.velocity = QPointF(qCos(heading), qSin(heading)) * (5.0 + random.generateDouble() * 45.0);
+        state.id += 1000;
+    }
+    // 距雷达40、切向速度120：一圈1.2秒内方位角变化约200度
+    DroneState orbiting = drones.first();
+    orbiting.id = 5000;
+    orbiting.position = QPointF(40.0, -10.0);
+    orbiting.velocity = QPointF(0.0, 120.0);
+    drones.append(orbiting);
+
+    bool passed = true;
+    quint64 sequence = 0;
+    for (int tick = 0; tick < sectorCount * 3; ++tick) {
+        if (tick == sectorCount + 5) {
+            DroneState late = drones.first();
+            late.id = 7; // 圈中出现，ID小于已入索引的所有目标
+            late.position = QPointF(300.0, 300.0);
+            late.velocity = QPointF(-20.0, 0.0);
+            drones.append(late);
+        }
+
+        DroneSnapshot snapshot;
+        snapshot.sequence = ++sequence;
+        snapshot.drones = drones;
+        for (int i = 0; i < drones.size(); ++i) {
+            snapshot.indexById.insert(drones[i].id, i);
+        }
+
+        const int sector = tick % sectorCount;
+        const double beamStart = sector * 2 * M_PI / sectorCount;
+        const double beamEnd = beamStart + 2 * M_PI / sectorCount;
+        QSet<int> expected;
+        RadarDetection detection;
+        for (const DroneState& state : drones) {
+            if (RadarWorker::detectState(state, QPointF(0, 0), 800.0, 0, detection)
+                && detection.azimuth >= beamStart && detection.azimuth < beamEnd) {
+                expected.insert(state.id);
+            }
+        }
+
+        sectorDetections.clear();
+        worker.performSectorScan(snapshot, 0);
+        QSet<int> found = detectionIds(sectorDetections);
+        if (found != expected) {
+            out << "  tick " << tick << " sector " << sector << ": scanned " << found.size()
+                << " drones, expected " << expected.size() << Qt::endl;
+            passed = false;
+        }
+
+        for (DroneState& state : drones) {
+            state.position += state.velocity * (intervalMs / 1000.0);
+        }
+    }
+    return passed;
+}
+
+bool Diagnostics::checkRenderBufferSwap(QTextStream& out)
+{
+    // 依次渲染目标在A、B、A三帧：每帧贴出的前缓冲只能含当前帧的目标，
+    // 证明渲染写入的是后缓冲、完成后与前缓冲交换，且被换回的旧前缓冲在复用前已清空
+    RadarRenderWorker worker;
+    RadarScene scene;
+    scene.size = QSize(200, 200);
+    scene.scaleFactor = 1.0;
+    scene.radarRadius = 100.0;
+    scene.showTrails = false;
+    scene.showInfo = false;
+
+    RenderDrone drone;
+    drone.id = 1;
+    drone.color = qRgb(255, 0, 0);
+    scene.drones.append(drone);
+
+    const QPointF positions[] = { QPointF(40, 0), QPointF(-40, 0), QPointF(40, 0) };
+    bool passed = true;
+    for (int frame = 0; frame < 3; ++frame) {
+        scene.drones[0].position = positions[frame];
+        worker.renderScene(scene);
+
+        QImage presented(scene.size, QImage::Format_ARGB32_Premultiplied);
+        presented.fill(Qt::transparent);
+        QPainter painter(&presented);
+        worker.presentFrame(painter);
+        painter.end();
+
+        const QPointF previous = positions[(frame + 1) % 2];
+        if (!hasInkNear(presented, positions[frame]) || hasInkNear(presented, previous)) {
+            out << "  frame " << frame << ": current target drawn: "
+                << (hasInkNear(presented, positions[frame]) ? "yes" : "no")
+                << ", previous target still visible: " << (hasInkNear(presented, previous) ? "yes" : "no")
+                << Qt::endl;
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+bool Diagnostics::checkJournalRoundTrip(QTextStream& out)
+{
+    // 写入N条记录并sync，读取器逐字段比对；再在末尾追加半条记录，
+    // 读取器和续写的写入器都必须只认N条完整记录
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        out << "  cannot create temporary directory" << Qt::endl;
+        return false;
+    }
+    const QString filename = dir.filePath("round_trip.evj");
+    const int recordCount = 1000;
+    const qint64 sessionStart = 1700000000000LL;
+
+    auto expected = [](int i) {
+        return StatisticsEvent(sessionStart + i * 7, static_cast<EventType>(i % EventTypeCount),
+                               i - 1, QPointF(i * 0.25, -i * 1.5), i / 3.0);
+    };
+
+    {
+        EventJournal journal;
+        journal.setBatchSize(64); // 让满批写出也在同步线程中发生若干次
+        if (!journal.open(filename, sessionStart)) {
+            out << "  cannot open journal for writing" << Qt::endl;
+            return false;
+        }
+        for (int i = 0; i < recordCount; ++i) {
+            journal.append(expected(i));
+        }
+        journal.sync();
+    }
+
+    bool passed = true;
+    auto verify = [&](const char* stage) {
+        EventJournalReader reader;
+        if (!reader.open(filename)) {
+            out << "  " << stage << ": reader failed to open journal" << Qt::endl;
+            passed = false;
+            return;
+        }
+        if (reader.getSessionStartTime() != sessionStart || reader.recordCount() != recordCount) {
+            out << "  " << stage << ": session start " << reader.getSessionStartTime()
+                << ", " << reader.recordCount() << " records, expected " << recordCount << Qt::endl;
+            passed = false;
+            return;
+        }
+        for (int i = 0; i < recordCount; ++i) {
+            StatisticsEvent want = expected(i);
+            StatisticsEvent got = reader.record(i);
+            if (got.timestamp != want.timestamp || got.type != want.type || got.droneId != want.droneId
+                || got.position != want.position || got.value != want.value) {
+                out << "  " << stage << ": record " << i << " differs" << Qt::endl;
+                passed = false;
+                return;
+            }
+        }
+    };
+    verify("after sync");
+
+    // 模拟写到一半时进程退出：末尾留下不完整的记录
+    {
+        QFile file(filename);
+        if (!file.open(QIODevice::Append)) {
+            out << "  cannot append truncated tail" << Qt::endl;
+            return false;
+        }
+        file.write(QByteArray(EventJournalFormat::RecordSize / 2, '\x5a'));
+    }
+    verify("with truncated tail");
+
+    {
+        EventJournal journal;
+        if (!journal.open(filename, sessionStart) || journal.getRecordCount() != recordCount) {
+            out << "  resumed journal counts " << journal.getRecordCount()
+                << " records, expected " << recordCount << Qt::endl;
+            passed = false;
+        }
+    }
+    if (QFileInfo(filename).size() != EventJournalFormat::HeaderSize + qint64(recordCount) * EventJournalFormat::RecordSize) {
+        out << "  resumed journal did not drop the truncated tail" << Qt::endl;
+        passed = false;
+    }
+    verify("after resume");
+    return passed;
+}
@@ -1,6 +1,10 @@
 #include "DroneManager.h"
+#include "MetricsRegistry.h"
+#include "Tracing.h"
 #include <QDebug>
 #include <QtMath>
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <algorithm>
 
 DroneManager::DroneManager(double squareSize, QObject *parent)
@@ -8,14 +12,21 @@ DroneManager::DroneManager(double squareSize, QObject *parent)
     , m_squareSize(squareSize)
     , m_nextDroneId(1)
     , m_generationInterval(3000)
+    , m_snapshotSequence(0)
     , m_radarCenter(0, 0)// 默认3秒
 {
     m_updateTimer = new QTimer(this);
     m_generationTimer = new QTimer(this);
     m_randomGenerator = QRandomGenerator::global();
     
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    m_tickDuration = registry.timer("radar_drone_tick_duration_seconds", "Drone update tick time");
+    m_activeDrones = registry.gauge("radar_drones_active", "Active drones in the latest snapshot");
+    
     connect(m_updateTimer, &QTimer::timeout, this, &DroneManager::updateAllDrones);
     connect(m_generationTimer, &QTimer::timeout, this, &DroneManager::generateRandomDrone);
+    
+    publishSnapshot();
 }
 
 DroneManager::~DroneManager()
@@ -41,6 +52,7 @@ void DroneManager::addDrone(int id, QPointF initialPos, double vx, double vy, Dr
             this, &DroneManager::onDroneDestroyed);
     
     m_drones.append(drone);
+    publishSnapshot();
     emit droneAdded(id);
     
     QString typeStr = "Standard"; // 统一类型
@@ -68,6 +80,7 @@ void DroneManager::addDroneWithTrajectory(int id, QPointF startPos, QPointF endP
             this, &DroneManager::onDroneDestroyed);
     
     m_drones.append(drone);
+    publishSnapshot();
     emit droneAdded(id);
     
     QString typeStr = "Standard"; // 统一类型
@@ -85,6 +98,7 @@ void DroneManager::removeDrone(int id)
         if (m_drones[i]->getId() == id) {
             Drone* drone = m_drones.takeAt(i);
             drone->deleteLater();
+            publishSnapshot();
             emit droneRemoved(id);
             qDebug() << "Removed drone" << id;
             return;
@@ -99,6 +113,7 @@ void DroneManager::removeAllDrones()
         emit droneRemoved(drone->getId());
         drone->deleteLater();
     }
+    publishSnapshot();
 }
 
 // 修改generateRandomDrone方法
@@ -200,6 +215,43 @@ Drone* DroneManager::getDroneById(int id) const
     return nullptr;
 }
 
+DroneSnapshotPtr DroneManager::getSnapshot() const
+{
+    QMutexLocker locker(&m_snapshotMutex);
+    return m_snapshot;
+}
+
+void DroneManager::publishSnapshot()
+{
+    // 在锁外构建新快照，锁内只交换指针，读者持锁时间极短
+    QSharedPointer<DroneSnapshot> snapshot(new DroneSnapshot);
+    snapshot->sequence = ++m_snapshotSequence;
+    snapshot->timestamp = QDateTime::currentMSecsSinceEpoch();
+    snapshot->drones.reserve(m_drones.size());
+    snapshot->indexById.reserve(m_drones.size());
+
+    for (const Drone* drone : m_drones) {
+        if (!drone->isActive()) {
+            continue;
+        }
+        DroneState state;
+        state.id = drone->getId();
+        state.position = drone->getCurrentPosition();
+        state.velocity = QPointF(drone->getVelocityX(), drone->getVelocityY());
+        state.trajectoryType = drone->getTrajectoryType();
+        state.speedType = drone->getSpeedType();
+        state.currentDirection = drone->getCurrentDirection();
+        state.currentSpeed = drone->getCurrentSpeed();
+        snapshot->indexById.insert(state.id, snapshot->drones.size());
+        snapshot->drones.append(state);
+    }
+
+    m_activeDrones->set(snapshot->drones.size());
+
+    QMutexLocker locker(&m_snapshotMutex);
+    m_snapshot = snapshot;
+}
+
 void DroneManager::startUpdateLoop(int intervalMs)
 {
     m_updateTimer->start(intervalMs);
@@ -215,6 +267,9 @@ void DroneManager::stopUpdateLoop()
 // 修改updateAllDrones方法，添加速度变化逻辑
 void DroneManager::updateAllDrones()
 {
+    RADAR_TRACE_SCOPE("DroneManager::updateAllDrones");
+    QElapsedTimer tickTimer;
+    tickTimer.start();
     QList<int> dronesOutOfBounds;
 
     for (Drone* drone : m_drones) {
@@ -237,6 +292,9 @@ void DroneManager::updateAllDrones()
     for (int id : dronesOutOfBounds) {
         onDroneOutOfBounds(id);
     }
+
+    publishSnapshot();
+    m_tickDuration->record(tickTimer.nsecsElapsed() / 1000);
 }
 
 // 修改applyRandomVelocityChange方法，增加变化频率和幅度
@@ -0,0 +1,258 @@
+#include "EventJournal.h"
+#include <QDebug>
+#include <QtEndian>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+void putDouble(uchar* dst, double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    qToLittleEndian<quint64>(bits, dst);
+}
+
+double getDouble(const uchar* src)
+{
+    quint64 bits = qFromLittleEndian<quint64>(src);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+}
+
+EventJournal::EventJournal(QObject *parent)
+    : QObject(parent)
+    , m_unsynced(false)
+    , m_flushQueued(false)
+    , m_batchRecords(256)
+    , m_recordCount(0)
+{
+    // fsync可能耗时数十毫秒，放到同步线程中执行，避免卡住界面线程
+    m_syncThread = new QThread(this);
+    m_syncThread->setObjectName("EventJournalSyncThread");
+    m_syncTimer = new QTimer();
+    m_syncTimer->setInterval(1000); // 每秒同步一次
+    m_syncTimer->moveToThread(m_syncThread);
+    // 以定时器为上下文对象，sync在同步线程中执行
+    connect(m_syncTimer, &QTimer::timeout, m_syncTimer, [this]() { sync(); });
+    connect(m_syncThread, &QThread::finished, m_syncTimer, &QObject::deleteLater);
+    m_syncThread->start();
+}
+
+EventJournal::~EventJournal()
+{
+    close();
+    m_syncThread->quit();
+    m_syncThread->wait();
+}
+
+void EventJournal::setSyncInterval(int ms)
+{
+    QMetaObject::invokeMethod(m_syncTimer, [timer = m_syncTimer, ms]() {
+        timer->setInterval(ms);
+    }, Qt::QueuedConnection);
+}
+
+bool EventJournal::open(const QString& filename, qint64 sessionStartTime)
+{
+    close();
+
+    QMutexLocker locker(&m_fileMutex);
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qDebug() << "Failed to open event journal" << filename << ":" << m_file.errorString();
+        return false;
+    }
+
+    if (m_file.size() >= EventJournalFormat::HeaderSize) {
+        // 续写已有日志：校验文件头，丢弃末尾不完整的记录
+        uchar header[EventJournalFormat::HeaderSize];
+        if (m_file.read(reinterpret_cast<char*>(header), sizeof(header)) != sizeof(header)
+            || qFromLittleEndian<quint32>(header) != EventJournalFormat::Magic
+            || qFromLittleEndian<quint32>(header + 8) != quint32(EventJournalFormat::RecordSize)) {
+            qDebug() << "Event journal" << filename << "has an incompatible header";
+            m_file.close();
+            return false;
+        }
+        m_recordCount = (m_file.size() - EventJournalFormat::HeaderSize) / EventJournalFormat::RecordSize;
+        m_file.resize(EventJournalFormat::HeaderSize + m_recordCount * EventJournalFormat::RecordSize);
+    } else {
+        uchar header[EventJournalFormat::HeaderSize] = {};
+        qToLittleEndian<quint32>(EventJournalFormat::Magic, header);
+        qToLittleEndian<quint32>(EventJournalFormat::Version, header + 4);
+        qToLittleEndian<quint32>(quint32(EventJournalFormat::RecordSize), header + 8);
+        qToLittleEndian<qint64>(sessionStartTime, header + 16);
+        m_file.resize(0);
+        m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        m_recordCount = 0;
+        m_unsynced = true;
+    }
+
+    m_file.seek(m_file.size());
+    m_writeBuffer.reserve(m_batchRecords * EventJournalFormat::RecordSize);
+    {
+        QMutexLocker pendingLocker(&m_pendingMutex);
+        m_pending.reserve(m_batchRecords * EventJournalFormat::RecordSize);
+    }
+    QMetaObject::invokeMethod(m_syncTimer, [timer = m_syncTimer]() { timer->start(); }, Qt::QueuedConnection);
+    return true;
+}
+
+void EventJournal::close()
+{
+    if (!isOpen()) {
+        return;
+    }
+    // 先停掉同步线程中的定时器，再在当前线程写出剩余记录
+    QMetaObject::invokeMethod(m_syncTimer, [timer = m_syncTimer]() { timer->stop(); }, Qt::BlockingQueuedConnection);
+    sync();
+
+    QMutexLocker locker(&m_fileMutex);
+    m_file.close();
+}
+
+void EventJournal::append(const StatisticsEvent& event)
+{
+    append(event.timestamp, event.type, event.droneId, event.position, event.value);
+}
+
+void EventJournal::append(qint64 timestamp, EventType type, int droneId, QPointF position, double value)
+{
+    if (!isOpen()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_pendingMutex);
+    int offset = m_pending.size();
+    m_pending.resize(offset + EventJournalFormat::RecordSize);
+    uchar* record = reinterpret_cast<uchar*>(m_pending.data()) + offset;
+    qToLittleEndian<qint64>(timestamp, record);
+    qToLittleEndian<quint32>(quint32(type), record + 8);
+    qToLittleEndian<qint32>(droneId, record + 12);
+    putDouble(record + 16, position.x());
+    putDouble(record + 24, position.y());
+    putDouble(record + 32, value);
+    ++m_recordCount;
+
+    // 满一批时请求同步线程写文件；同步到磁盘仍由定时器负责
+    if (!m_flushQueued && m_pending.size() >= m_batchRecords * EventJournalFormat::RecordSize) {
+        m_flushQueued = true;
+        QMetaObject::invokeMethod(m_syncTimer, [this]() {
+            QMutexLocker fileLocker(&m_fileMutex);
+            writePending();
+        }, Qt::QueuedConnection);
+    }
+}
+
+// 调用方持有m_fileMutex
+bool EventJournal::writePending()
+{
+    {
+        // 与写缓冲交换，写文件期间append可以继续填充另一块缓冲
+        QMutexLocker locker(&m_pendingMutex);
+        m_writeBuffer.swap(m_pending);
+        m_flushQueued = false;
+    }
+    if (m_writeBuffer.isEmpty() || !m_file.isOpen()) {
+        m_writeBuffer.resize(0);
+        return true;
+    }
+    bool ok = m_file.write(m_writeBuffer) == m_writeBuffer.size();
+    if (!ok) {
+        qDebug() << "Event journal write failed:" << m_file.errorString();
+    }
+    m_writeBuffer.resize(0); // 保留容量
+    m_unsynced = true;
+    return ok;
+}
+
+void EventJournal::sync()
+{
+    QMutexLocker locker(&m_fileMutex);
+    if (!m_file.isOpen()) {
+        return;
+    }
+    writePending();
+    if (!m_unsynced) {
+        return;
+    }
+
+    m_file.flush();
+#ifdef Q_OS_WIN
+    _commit(m_file.handle());
+#else
+    ::fsync(m_file.handle());
+#endif
+    m_unsynced = false;
+}
+
+EventJournalReader::EventJournalReader()
+    : m_data(nullptr)
+    , m_recordCount(0)
+    , m_sessionStartTime(0)
+{
+}
+
+EventJournalReader::~EventJournalReader()
+{
+    close();
+}
+
+bool EventJournalReader::open(const QString& filename)
+{
+    close();
+
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::ReadOnly) || m_file.size() < EventJournalFormat::HeaderSize) {
+        m_file.close();
+        return false;
+    }
+
+    const uchar* data = m_file.map(0, m_file.size());
+    if (!data) {
+        qDebug() << "Failed to map event journal" << filename << ":" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    if (qFromLittleEndian<quint32>(data) != EventJournalFormat::Magic
+        || qFromLittleEndian<quint32>(data + 8) != quint32(EventJournalFormat::RecordSize)) {
+        m_file.unmap(const_cast<uchar*>(data));
+        m_file.close();
+        return false;
+    }
+
+    m_data = data;
+    m_sessionStartTime = qFromLittleEndian<qint64>(data + 16);
+    // 写入中途的不完整记录不计入
+    m_recordCount = (m_file.size() - EventJournalFormat::HeaderSize) / EventJournalFormat::RecordSize;
+    return true;
+}
+
+void EventJournalReader::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_recordCount = 0;
+    m_sessionStartTime = 0;
+}
+
+StatisticsEvent EventJournalReader::record(qint64 index) const
+{
+    const uchar* record = m_data + EventJournalFormat::HeaderSize + index * EventJournalFormat::RecordSize;
+
+    return StatisticsEvent(qFromLittleEndian<qint64>(record),
+                           static_cast<EventType>(qFromLittleEndian<quint32>(record + 8)),
+                           qFromLittleEndian<qint32>(record + 12),
+                           QPointF(getDouble(record + 16), getDouble(record + 24)),
+                           getDouble(record + 32));
+}
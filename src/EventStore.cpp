@@ -0,0 +1,258 @@
+#include "EventStore.h"
+#include <algorithm>
+
+void EventColumns::append(const StatisticsEvent& event)
+{
+    m_rowsByType[int(event.type)].append(m_timestamps.size());
+    m_timestamps.append(event.timestamp);
+    m_types.append(quint8(event.type));
+    m_droneIds.append(event.droneId);
+    m_xs.append(event.position.x());
+    m_ys.append(event.position.y());
+    m_values.append(event.value);
+    m_minTimestamp = qMin(m_minTimestamp, event.timestamp);
+    m_maxTimestamp = qMax(m_maxTimestamp, event.timestamp);
+}
+
+void EventColumns::appendRows(const EventColumns& other)
+{
+    const int offset = m_timestamps.size();
+    m_timestamps.append(other.m_timestamps);
+    m_types.append(other.m_types);
+    m_droneIds.append(other.m_droneIds);
+    m_xs.append(other.m_xs);
+    m_ys.append(other.m_ys);
+    m_values.append(other.m_values);
+    for (int i = 0; i < EventTypeCount; ++i) {
+        QVector<int>& rows = m_rowsByType[i];
+        rows.reserve(rows.size() + other.m_rowsByType[i].size());
+        for (int row : other.m_rowsByType[i]) {
+            rows.append(offset + row);
+        }
+    }
+    m_minTimestamp = qMin(m_minTimestamp, other.m_minTimestamp);
+    m_maxTimestamp = qMax(m_maxTimestamp, other.m_maxTimestamp);
+}
+
+void EventColumns::clear()
+{
+    m_timestamps.clear();
+    m_types.clear();
+    m_droneIds.clear();
+    m_xs.clear();
+    m_ys.clear();
+    m_values.clear();
+    for (QVector<int>& rows : m_rowsByType) {
+        rows.clear();
+    }
+    m_minTimestamp = std::numeric_limits<qint64>::max();
+    m_maxTimestamp = std::numeric_limits<qint64>::min();
+}
+
+void EventColumns::swap(EventColumns& other)
+{
+    m_timestamps.swap(other.m_timestamps);
+    m_types.swap(other.m_types);
+    m_droneIds.swap(other.m_droneIds);
+    m_xs.swap(other.m_xs);
+    m_ys.swap(other.m_ys);
+    m_values.swap(other.m_values);
+    for (int i = 0; i < EventTypeCount; ++i) {
+        m_rowsByType[i].swap(other.m_rowsByType[i]);
+    }
+    std::swap(m_minTimestamp, other.m_minTimestamp);
+    std::swap(m_maxTimestamp, other.m_maxTimestamp);
+}
+
+int EventColumns::removeBefore(qint64 cutoffTime)
+{
+    // 原地压缩保留的行，类型行号随之重建
+    int kept = 0;
+    for (QVector<int>& rows : m_rowsByType) {
+        rows.clear();
+    }
+    m_minTimestamp = std::numeric_limits<qint64>::max();
+    m_maxTimestamp = std::numeric_limits<qint64>::min();
+    for (int row = 0; row < m_timestamps.size(); ++row) {
+        if (m_timestamps[row] < cutoffTime) {
+            continue;
+        }
+        m_timestamps[kept] = m_timestamps[row];
+        m_types[kept] = m_types[row];
+        m_droneIds[kept] = m_droneIds[row];
+        m_xs[kept] = m_xs[row];
+        m_ys[kept] = m_ys[row];
+        m_values[kept] = m_values[row];
+        m_rowsByType[m_types[kept]].append(kept);
+        m_minTimestamp = qMin(m_minTimestamp, m_timestamps[kept]);
+        m_maxTimestamp = qMax(m_maxTimestamp, m_timestamps[kept]);
+        ++kept;
+    }
+
+    int removed = m_timestamps.size() - kept;
+    m_timestamps.resize(kept);
+    m_types.resize(kept);
+    m_droneIds.resize(kept);
+    m_xs.resize(kept);
+    m_ys.resize(kept);
+    m_values.resize(kept);
+    return removed;
+}
+
+EventStore::EventStore(int ringSeconds)
+    : m_ring(qMax(1, ringSeconds))
+    , m_newestSecond(-1)
+    , m_size(0)
+    , m_typeCounts{}
+    , m_archiveEnabled(true)
+{
+}
+
+void EventStore::append(const StatisticsEvent& event)
+{
+    qint64 second = event.timestamp / 1000;
+
+    if (second > m_newestSecond) {
+        advanceTo(second);
+    }
+
+    if (second < oldestRingSecond()) {
+        // 早于环形窗口的迟到事件（如系统时间回拨）追加到最后一个归档块，
+        // 块的时间范围随之扩展，按时间裁剪和查询时不会被漏掉
+        if (!m_archiveEnabled) {
+            return;
+        }
+        if (m_archive.isEmpty()) {
+            m_archive.append(EventColumns());
+        }
+        m_archive.last().append(event);
+        ++m_size;
+        ++m_typeCounts[int(event.type)];
+        return;
+    }
+
+    Bucket& bucket = m_ring[int(second % m_ring.size())];
+    if (bucket.second != second) {
+        retireBucket(bucket);
+        bucket.second = second;
+    }
+    bucket.events.append(event);
+    ++m_size;
+    ++m_typeCounts[int(event.type)];
+}
+
+void EventStore::advanceTo(qint64 second)
+{
+    if (m_newestSecond < 0) {
+        m_newestSecond = second; // 第一条事件，环中没有需要归档的桶
+        return;
+    }
+
+    if (second - m_newestSecond >= m_ring.size()) {
+        // 跨度超过整个环：所有桶都滑出窗口，按时间顺序而不是槽位顺序移入归档，
+        // 保证归档块的时间顺序（forEach、forEachInWindow依赖这一点）
+        for (qint64 s = qMax<qint64>(0, oldestRingSecond()); s <= m_newestSecond; ++s) {
+            Bucket& bucket = m_ring[int(s % m_ring.size())];
+            if (bucket.second == s) {
+                retireBucket(bucket);
+            }
+        }
+        m_newestSecond = second;
+        return;
+    }
+
+    // 新的一秒复用滑出窗口的槽位，槽位s中是s-环长那一秒，逐秒推进即按时间顺序归档
+    for (qint64 s = m_newestSecond + 1; s <= second; ++s) {
+        Bucket& bucket = m_ring[int(s % m_ring.size())];
+        if (bucket.second != s) {
+            retireBucket(bucket);
+        }
+    }
+    m_newestSecond = second;
+}
+
+void EventStore::retireBucket(Bucket& bucket)
+{
+    if (bucket.second < 0 || bucket.events.isEmpty()) {
+        bucket.second = -1;
+        return;
+    }
+
+    if (m_archiveEnabled) {
+        if (m_archive.isEmpty() || m_archive.last().size() >= ArchiveChunkRows) {
+            // 开新块：整个桶交换进去，槽位拿到一个空块
+            m_archive.append(EventColumns());
+            m_archive.last().swap(bucket.events);
+        } else {
+            // 追加到未满的最后一块；clear()保留容量，槽位下一秒复用已有的分配
+            m_archive.last().appendRows(bucket.events);
+            bucket.events.clear();
+        }
+    } else {
+        discardRows(bucket.events);
+        bucket.events.clear();
+    }
+    bucket.second = -1;
+}
+
+void EventStore::discardRows(const EventColumns& events)
+{
+    m_size -= events.size();
+    for (int i = 0; i < EventTypeCount; ++i) {
+        m_typeCounts[i] -= events.rowsOfType(EventType(i)).size();
+    }
+}
+
+void EventStore::clear()
+{
+    for (Bucket& bucket : m_ring) {
+        bucket.second = -1;
+        bucket.events.clear();
+    }
+    m_archive.clear();
+    m_newestSecond = -1;
+    m_size = 0;
+    std::fill(std::begin(m_typeCounts), std::end(m_typeCounts), 0);
+}
+
+void EventStore::removeBefore(qint64 cutoffTime)
+{
+    auto removeExpired = [this, cutoffTime](EventColumns& events) {
+        // 先扣除全部行再加回保留的行，类型计数无需逐行判断
+        discardRows(events);
+        events.removeBefore(cutoffTime);
+        m_size += events.size();
+        for (int i = 0; i < EventTypeCount; ++i) {
+            m_typeCounts[i] += events.rowsOfType(EventType(i)).size();
+        }
+    };
+
+    // 归档块的最晚时间戳随块序递增：从头丢弃整块过期的块；
+    // 迟到事件可能落在任意后续块中，最早时间戳早于截止时间的块都需要逐条过滤
+    int expiredChunks = 0;
+    while (expiredChunks < m_archive.size() && m_archive[expiredChunks].maxTimestamp() < cutoffTime) {
+        discardRows(m_archive[expiredChunks]);
+        ++expiredChunks;
+    }
+    m_archive.remove(0, expiredChunks);
+
+    for (EventColumns& chunk : m_archive) {
+        if (chunk.minTimestamp() < cutoffTime) {
+            removeExpired(chunk);
+        }
+    }
+
+    qint64 cutoffSecond = cutoffTime / 1000;
+    for (Bucket& bucket : m_ring) {
+        if (bucket.second < 0 || bucket.second > cutoffSecond) {
+            continue;
+        }
+        if (bucket.second < cutoffSecond) {
+            discardRows(bucket.events);
+            bucket.events.clear();
+            bucket.second = -1;
+        } else {
+            removeExpired(bucket.events);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#include "FrameScheduler.h"
+
+FrameScheduler::FrameScheduler(QObject *parent)
+    : QObject(parent)
+    , m_targetFps(30)
+    , m_dirty(true)
+    , m_animationSources(0)
+    , m_lastTickTime(0)
+    , m_fpsWindowStart(0)
+    , m_framesInWindow(0)
+    , m_skippedFrames(0)
+    , m_actualFps(0.0)
+{
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setTimerType(Qt::PreciseTimer); // 精确定时，帧间隔稳定
+    connect(m_frameTimer, &QTimer::timeout, this, &FrameScheduler::onTimerTick);
+    m_clock.start();
+}
+
+void FrameScheduler::setTargetFps(int fps)
+{
+    m_targetFps = qBound(1, fps, 120);
+    if (m_frameTimer->isActive()) {
+        m_frameTimer->start(1000 / m_targetFps);
+    }
+}
+
+void FrameScheduler::setAnimationActive(quint32 source, bool active)
+{
+    if (active) {
+        m_animationSources |= source;
+    } else {
+        m_animationSources &= ~source;
+    }
+}
+
+void FrameScheduler::start()
+{
+    m_lastTickTime = m_clock.elapsed();
+    m_fpsWindowStart = m_lastTickTime;
+    m_framesInWindow = 0;
+    m_frameTimer->start(1000 / m_targetFps);
+}
+
+void FrameScheduler::stop()
+{
+    m_frameTimer->stop();
+}
+
+void FrameScheduler::onTimerTick()
+{
+    qint64 now = m_clock.elapsed();
+    qint64 elapsed = now - m_lastTickTime;
+    m_lastTickTime = now;
+
+    emit frameTick(elapsed);
+
+    if (m_dirty || m_animationSources != 0) {
+        m_dirty = false;
+        emit frameReady();
+    } else {
+        ++m_skippedFrames;
+    }
+
+    // 每秒更新一次实际帧率
+    if (now - m_fpsWindowStart >= 1000) {
+        m_actualFps = m_framesInWindow * 1000.0 / (now - m_fpsWindowStart);
+        m_fpsWindowStart = now;
+        m_framesInWindow = 0;
+        emit fpsUpdated(m_actualFps);
+    }
+}
+
+void FrameScheduler::framePresented()
+{
+    ++m_framesInWindow;
+}
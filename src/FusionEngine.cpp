@@ -0,0 +1,303 @@
+#include "FusionEngine.h"
+#include "MetricsRegistry.h"
+#include <QDebug>
+#include <QDataStream>
+#include <QIODevice>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QtMath>
+
+FusionEngine::FusionEngine(QObject *parent)
+    : QObject(parent)
+    , m_cycleTimer(nullptr)
+    , m_udpSocket(nullptr)
+    , m_trackGrid(100.0)
+    , m_nextFusedId(1)
+    , m_cycleInterval(100)
+    , m_gateRadius(30.0)
+    , m_trackTimeoutMs(3000)
+    , m_lastCycleTime(0)
+    , m_lastCycleUs(0)
+    , m_maxCycleUs(0)
+    , m_cycleDuration(MetricsRegistry::instance().timer("radar_fusion_cycle_duration_seconds",
+                                                        "Track fusion cycle time"))
+{
+    qRegisterMetaType<FusedTrack>("FusedTrack");
+    qRegisterMetaType<QList<FusedTrack>>("QList<FusedTrack>");
+}
+
+FusionEngine::~FusionEngine()
+{
+    stop();
+}
+
+void FusionEngine::start(int cycleMs)
+{
+    if (!m_cycleTimer) {
+        m_cycleTimer = new QTimer(this);
+        m_cycleTimer->setTimerType(Qt::PreciseTimer);
+        connect(m_cycleTimer, &QTimer::timeout, this, &FusionEngine::performFusionCycle);
+    }
+
+    m_cycleInterval = cycleMs;
+    m_lastCycleTime = QDateTime::currentMSecsSinceEpoch();
+    m_cycleTimer->start(m_cycleInterval);
+    qDebug() << "Fusion engine started with cycle:" << m_cycleInterval << "ms";
+}
+
+void FusionEngine::stop()
+{
+    if (m_cycleTimer && m_cycleTimer->isActive()) {
+        m_cycleTimer->stop();
+    }
+}
+
+void FusionEngine::submitDetections(int sourceId, const QList<RadarDetection>& detections)
+{
+    // 同一周期内同一雷达源多次上报时只保留最新一次
+    m_pendingDetections.insert(sourceId, detections);
+}
+
+void FusionEngine::removeSource(int sourceId)
+{
+    m_pendingDetections.remove(sourceId);
+}
+
+void FusionEngine::addClient(const QHostAddress& address, quint16 port)
+{
+    if (!m_udpSocket) {
+        m_udpSocket = new QUdpSocket(this);
+    }
+
+    QPair<QHostAddress, quint16> client(address, port);
+    if (!m_clients.contains(client)) {
+        m_clients.append(client);
+    }
+}
+
+void FusionEngine::reset()
+{
+    m_pendingDetections.clear();
+    m_tracks.clear();
+    m_accumulators.clear();
+    m_trackGrid.clear();
+    m_maxCycleUs = 0;
+}
+
+void FusionEngine::accumulate(int slot, int sourceId, const RadarDetection& detection)
+{
+    // 距离加权：离雷达越近的检测精度越高，权重越大
+    double weight = 1.0 / qMax(1.0, detection.distance);
+
+    FusionAccumulator& acc = m_accumulators[slot];
+    acc.weight += weight;
+    acc.weightedPosition += detection.position * weight;
+    acc.weightedVelocity += detection.velocity * weight;
+    acc.count++;
+    acc.lastSourceId = sourceId;
+    if (weight > acc.bestWeight) {
+        acc.bestWeight = weight;
+        acc.bestDroneId = detection.droneId;
+    }
+}
+
+int FusionEngine::createTrack(const RadarDetection& detection, qint64 currentTime)
+{
+    FusedTrack track;
+    track.fusedId = m_nextFusedId++;
+    track.droneId = detection.droneId;
+    track.position = detection.position;
+    track.velocity = detection.velocity;
+    track.lastUpdateTime = currentTime;
+    track.sourceCount = 0;
+    m_tracks.append(track);
+
+    FusionAccumulator acc = { 0.0, 0.0, QPointF(0, 0), QPointF(0, 0), detection.droneId, 0, -1 };
+    m_accumulators.append(acc);
+
+    int slot = m_tracks.size() - 1;
+    m_trackGrid.insert(slot, track.position);
+    return slot;
+}
+
+void FusionEngine::performFusionCycle()
+{
+    QElapsedTimer cycleTimer;
+    cycleTimer.start();
+
+    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+    double deltaTime = (currentTime - m_lastCycleTime) / 1000.0;
+    m_lastCycleTime = currentTime;
+
+    // 1. 预测现有航迹位置并重建门限索引
+    m_trackGrid.setCellSize(qMax(1.0, m_gateRadius * 2.0));
+    m_accumulators.resize(m_tracks.size());
+    for (int slot = 0; slot < m_tracks.size(); ++slot) {
+        FusedTrack& track = m_tracks[slot];
+        track.position += track.velocity * deltaTime;
+        m_accumulators[slot] = { 0.0, 0.0, QPointF(0, 0), QPointF(0, 0), track.droneId, 0, -1 };
+        m_trackGrid.insert(slot, track.position);
+    }
+
+    // 2. 关联：每个检测匹配门限内最近、且本周期尚未被同一雷达源占用的航迹
+    for (auto it = m_pendingDetections.constBegin(); it != m_pendingDetections.constEnd(); ++it) {
+        const int sourceId = it.key();
+        for (const RadarDetection& detection : it.value()) {
+            int bestSlot = -1;
+            double bestDistanceSquared = m_gateRadius * m_gateRadius;
+
+            m_trackGrid.forEachInRadius(detection.position, m_gateRadius, [&](int slot, QPointF position) {
+                if (m_accumulators[slot].lastSourceId == sourceId) {
+                    return;
+                }
+                double dx = position.x() - detection.position.x();
+                double dy = position.y() - detection.position.y();
+                double distanceSquared = dx * dx + dy * dy;
+                if (distanceSquared <= bestDistanceSquared) {
+                    bestDistanceSquared = distanceSquared;
+                    bestSlot = slot;
+                }
+            });
+
+            if (bestSlot < 0) {
+                bestSlot = createTrack(detection, currentTime);
+            }
+            accumulate(bestSlot, sourceId, detection);
+        }
+    }
+    m_pendingDetections.clear();
+
+    // 3. 合并累加量，移除超时航迹（交换删除，保持数组连续）
+    QList<FusedTrack> fusedTracks;
+    fusedTracks.reserve(m_tracks.size());
+    int slot = 0;
+    while (slot < m_tracks.size()) {
+        FusedTrack& track = m_tracks[slot];
+        const FusionAccumulator& acc = m_accumulators[slot];
+
+        if (acc.count > 0) {
+            track.position = acc.weightedPosition / acc.weight;
+            track.velocity = acc.weightedVelocity / acc.weight;
+            track.droneId = acc.bestDroneId;
+            track.lastUpdateTime = currentTime;
+        }
+        track.sourceCount = acc.count;
+
+        if (currentTime - track.lastUpdateTime > m_trackTimeoutMs) {
+            int last = m_tracks.size() - 1;
+            m_tracks[slot] = m_tracks[last];
+            m_accumulators[slot] = m_accumulators[last];
+            m_tracks.removeLast();
+            m_accumulators.removeLast();
+            continue;
+        }
+
+        fusedTracks.append(track);
+        ++slot;
+    }
+    m_trackGrid.clear();
+
+    // 4. 独立的融合数据流
+    if (m_udpSocket && !m_clients.isEmpty()) {
+        QByteArray data = serializeFusedTracks(fusedTracks);
+        for (const QPair<QHostAddress, quint16>& client : m_clients) {
+            if (m_udpSocket->writeDatagram(data, client.first, client.second) == -1) {
+                qWarning() << "Failed to send fused tracks to" << client.first.toString() << ":" << client.second
+                           << m_udpSocket->errorString();
+            }
+        }
+    }
+
+    emit fusedTracksUpdated(fusedTracks);
+    m_lastFusedTracks = fusedTracks;
+
+    m_lastCycleUs = cycleTimer.nsecsElapsed() / 1000;
+    m_maxCycleUs = qMax(m_maxCycleUs, m_lastCycleUs);
+    m_cycleDuration->record(m_lastCycleUs);
+    if (m_lastCycleUs > qint64(m_cycleInterval) * 1000) {
+        qWarning() << "Fusion cycle over budget:" << m_lastCycleUs << "us for" << m_tracks.size() << "tracks";
+    }
+}
+
+QByteArray FusionEngine::serializeFusedTracks(const QList<FusedTrack>& tracks)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    // 融合航迹使用独立的魔术数字，与原始雷达数据流区分
+    stream << quint32(0x46555345); // "FUSE"
+    stream << quint32(1);          // Version
+    stream << QDateTime::currentMSecsSinceEpoch();
+    stream << quint32(tracks.size());
+
+    for (const FusedTrack& track : tracks) {
+        stream << track.fusedId;
+        stream << track.droneId;
+        stream << track.position;
+        stream << track.velocity;
+        stream << track.lastUpdateTime;
+        stream << quint32(track.sourceCount);
+    }
+
+    return data;
+}
+
+FusionEngine::BenchmarkResult FusionEngine::runBenchmark(int trackCount, int sourceCount, int cycles)
+{
+    FusionEngine engine;
+    QRandomGenerator random(29);
+
+    // 目标按网格排布，间距为门限的4倍，保证关联结果唯一；每个周期移动的距离远小于门限
+    const double spacing = engine.m_gateRadius * 4.0;
+    const int columns = qMax(1, int(qCeil(qSqrt(trackCount))));
+    QVector<QPointF> positions(trackCount);
+    QVector<QPointF> velocities(trackCount);
+    for (int i = 0; i < trackCount; ++i) {
+        positions[i] = QPointF((i % columns) * spacing, (i / columns) * spacing);
+        double heading = random.generateDouble() * 2 * M_PI;
+        velocities[i] = QPointF(qCos(heading), qSin(heading)) * (10.0 + random.generateDouble() * 40.0);
+    }
+
+    BenchmarkResult result = { trackCount, sourceCount, cycles, 0, 0, 0, 0, qint64(engine.m_cycleInterval) * 1000 };
+    qint64 totalUs = 0;
+    const double cycleSeconds = engine.m_cycleInterval / 1000.0;
+    const double noise = engine.m_gateRadius / 4.0;
+
+    for (int cycle = 0; cycle < cycles; ++cycle) {
+        for (int source = 0; source < sourceCount; ++source) {
+            QList<RadarDetection> detections;
+            detections.reserve(trackCount);
+            for (int i = 0; i < trackCount; ++i) {
+                RadarDetection detection;
+                detection.droneId = i + 1;
+                detection.position = positions[i] + QPointF((random.generateDouble() * 2.0 - 1.0) * noise,
+                                                            (random.generateDouble() * 2.0 - 1.0) * noise);
+                detection.velocity = velocities[i];
+                detection.detectionTime = 0;
+                detection.distance = 100.0 + random.generateDouble() * 700.0;
+                detection.azimuth = 0.0;
+                detections.append(detection);
+            }
+            engine.submitDetections(source + 1, detections);
+        }
+
+        engine.performFusionCycle();
+        totalUs += engine.m_lastCycleUs;
+
+        for (int i = 0; i < trackCount; ++i) {
+            positions[i] += velocities[i] * cycleSeconds;
+        }
+    }
+
+    result.fusedTracks = engine.m_lastFusedTracks.size();
+    for (const FusedTrack& track : engine.m_lastFusedTracks) {
+        if (track.sourceCount == sourceCount) {
+            ++result.multiSourceTracks;
+        }
+    }
+    result.averageCycleUs = cycles > 0 ? totalUs / cycles : 0;
+    result.maxCycleUs = engine.m_maxCycleUs;
+    return result;
+}
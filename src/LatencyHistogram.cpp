@@ -0,0 +1,99 @@
+#include "LatencyHistogram.h"
+#include <QtMath>
+#include <QtAlgorithms>
+#include <limits>
+
+LatencyHistogram::LatencyHistogram()
+    : m_totalCount(0)
+    , m_min(std::numeric_limits<qint64>::max())
+    , m_max(0)
+    , m_sum(0.0)
+{
+}
+
+int LatencyHistogram::bucketIndex(qint64 value)
+{
+    // 小于子桶数的值一一对应；更大的值按最高位所在的段分组，段内取最高的SubBucketBits+1位
+    if (value < SubBucketCount) {
+        return int(value);
+    }
+    int shift = (63 - qCountLeadingZeroBits(quint64(value))) - SubBucketBits;
+    return shift * SubBucketCount + int(value >> shift);
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < SubBucketCount) {
+        return index;
+    }
+    int shift = index / SubBucketCount - 1;
+    qint64 mantissa = index - shift * SubBucketCount;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(qint64 value, qint64 count)
+{
+    if (count <= 0) {
+        return;
+    }
+    value = qMax<qint64>(0, value);
+
+    int index = bucketIndex(value);
+    if (index >= m_counts.size()) {
+        m_counts.resize(index + 1);
+    }
+    m_counts[index] += count;
+
+    m_totalCount += count;
+    m_sum += double(value) * count;
+    m_min = qMin(m_min, value);
+    m_max = qMax(m_max, value);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    if (other.m_totalCount == 0) {
+        return;
+    }
+    if (other.m_counts.size() > m_counts.size()) {
+        m_counts.resize(other.m_counts.size());
+    }
+    for (int i = 0; i < other.m_counts.size(); ++i) {
+        m_counts[i] += other.m_counts[i];
+    }
+
+    m_totalCount += other.m_totalCount;
+    m_sum += other.m_sum;
+    m_min = qMin(m_min, other.m_min);
+    m_max = qMax(m_max, other.m_max);
+}
+
+void LatencyHistogram::clear()
+{
+    m_counts.clear();
+    m_totalCount = 0;
+    m_min = std::numeric_limits<qint64>::max();
+    m_max = 0;
+    m_sum = 0.0;
+}
+
+qint64 LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (m_totalCount == 0) {
+        return 0;
+    }
+    if (percentile >= 100.0) {
+        return m_max;
+    }
+
+    // 第一个累计计数达到目标名次的桶
+    qint64 target = qMax<qint64>(1, qint64(qCeil(percentile / 100.0 * m_totalCount)));
+    qint64 cumulative = 0;
+    for (int i = 0; i < m_counts.size(); ++i) {
+        cumulative += m_counts[i];
+        if (cumulative >= target) {
+            return qBound(min(), bucketUpperBound(i), m_max);
+        }
+    }
+    return m_max;
+}
@@ -0,0 +1,176 @@
+#include "MetricsRegistry.h"
+#include <QMutexLocker>
+#include <chrono>
+
+namespace {
+const int SliceValueBits = 40;
+const quint64 SliceValueMask = (quint64(1) << SliceValueBits) - 1;
+const quint64 SliceEpochMask = (quint64(1) << (64 - SliceValueBits)) - 1;
+
+quint64 currentSliceEpoch(qint64 sliceMs)
+{
+    qint64 nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch()).count();
+    return quint64(nowMs / sliceMs) & SliceEpochMask;
+}
+}
+
+void MetricTimer::record(qint64 microseconds)
+{
+    microseconds = qMax<qint64>(0, microseconds);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumUs.fetch_add(quint64(microseconds), std::memory_order_relaxed);
+
+    // 分片属于更早的时间片时先整体替换，否则只在新值更大时写入
+    const quint64 epoch = currentSliceEpoch(MaxSliceMs);
+    const quint64 value = qMin(quint64(microseconds), SliceValueMask);
+    std::atomic<quint64>& slice = m_maxSlices[epoch % MaxSlices];
+    quint64 current = slice.load(std::memory_order_relaxed);
+    for (;;) {
+        quint64 updated;
+        if ((current >> SliceValueBits) != epoch) {
+            updated = (epoch << SliceValueBits) | value;
+        } else if (value > (current & SliceValueMask)) {
+            updated = (current & ~SliceValueMask) | value;
+        } else {
+            return;
+        }
+        if (slice.compare_exchange_weak(current, updated, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+qint64 MetricTimer::maxMicroseconds() const
+{
+    const quint64 epoch = currentSliceEpoch(MaxSliceMs);
+    quint64 result = 0;
+    for (const std::atomic<quint64>& slice : m_maxSlices) {
+        quint64 packed = slice.load(std::memory_order_relaxed);
+        if (((epoch - (packed >> SliceValueBits)) & SliceEpochMask) < quint64(MaxSlices)) {
+            result = qMax(result, packed & SliceValueMask);
+        }
+    }
+    return qint64(result);
+}
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Series& MetricsRegistry::series(const QString& name, const QString& help, Kind kind,
+                                                 const QString& labels)
+{
+    auto index = m_familyIndex.constFind(name);
+    if (index == m_familyIndex.constEnd()) {
+        Family family;
+        family.name = name;
+        family.help = help;
+        family.kind = kind;
+        m_families.append(family);
+        index = m_familyIndex.insert(name, m_families.size() - 1);
+    }
+
+    Family& family = m_families[index.value()];
+    for (Series& existing : family.series) {
+        if (existing.labels == labels) {
+            return existing;
+        }
+    }
+    Series created;
+    created.labels = labels;
+    family.series.append(created);
+    return family.series.last();
+}
+
+MetricCounter* MetricsRegistry::counter(const QString& name, const QString& help, const QString& labels)
+{
+    QMutexLocker locker(&m_mutex);
+    Series& entry = series(name, help, Kind::Counter, labels);
+    if (!entry.counter) {
+        m_counters.emplace_back(new MetricCounter);
+        entry.counter = m_counters.back().get();
+    }
+    return entry.counter;
+}
+
+MetricGauge* MetricsRegistry::gauge(const QString& name, const QString& help, const QString& labels)
+{
+    QMutexLocker locker(&m_mutex);
+    Series& entry = series(name, help, Kind::Gauge, labels);
+    if (!entry.gauge) {
+        m_gauges.emplace_back(new MetricGauge);
+        entry.gauge = m_gauges.back().get();
+    }
+    return entry.gauge;
+}
+
+MetricTimer* MetricsRegistry::timer(const QString& name, const QString& help, const QString& labels)
+{
+    QMutexLocker locker(&m_mutex);
+    Series& entry = series(name, help, Kind::Timer, labels);
+    if (!entry.timer) {
+        m_timers.emplace_back(new MetricTimer);
+        entry.timer = m_timers.back().get();
+    }
+    return entry.timer;
+}
+
+QByteArray MetricsRegistry::renderPrometheus()
+{
+    QMutexLocker locker(&m_mutex);
+
+    QByteArray out;
+    out.reserve(4096);
+
+    // 样本行：name{labels} value
+    auto appendSample = [&out](const QString& name, const char* suffix, const QString& labels,
+                               const QByteArray& value) {
+        out += name.toUtf8();
+        out += suffix;
+        if (!labels.isEmpty()) {
+            out += '{';
+            out += labels.toUtf8();
+            out += '}';
+        }
+        out += ' ';
+        out += value;
+        out += '\n';
+    };
+
+    for (const Family& family : m_families) {
+        QByteArray name = family.name.toUtf8();
+        out += "# HELP " + name + ' ' + family.help.toUtf8() + '\n';
+
+        switch (family.kind) {
+        case Kind::Counter:
+            out += "# TYPE " + name + " counter\n";
+            for (const Series& entry : family.series) {
+                appendSample(family.name, "", entry.labels, QByteArray::number(entry.counter->value()));
+            }
+            break;
+        case Kind::Gauge:
+            out += "# TYPE " + name + " gauge\n";
+            for (const Series& entry : family.series) {
+                appendSample(family.name, "", entry.labels, QByteArray::number(entry.gauge->value(), 'g', 12));
+            }
+            break;
+        case Kind::Timer:
+            out += "# TYPE " + name + " summary\n";
+            for (const Series& entry : family.series) {
+                appendSample(family.name, "_count", entry.labels, QByteArray::number(entry.timer->count()));
+                appendSample(family.name, "_sum", entry.labels,
+                             QByteArray::number(entry.timer->sumMicroseconds() / 1e6, 'g', 12));
+            }
+            out += "# TYPE " + name + "_max gauge\n";
+            for (const Series& entry : family.series) {
+                appendSample(family.name, "_max", entry.labels,
+                             QByteArray::number(entry.timer->maxMicroseconds() / 1e6, 'g', 12));
+            }
+            break;
+        }
+    }
+    return out;
+}
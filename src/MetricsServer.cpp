@@ -0,0 +1,174 @@
+#include "MetricsServer.h"
+#include "MetricsRegistry.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QTimer>
+#include <QDebug>
+
+namespace {
+const int MaxRequestHeaderSize = 8192;
+const int RequestIdleTimeoutMs = 5000;
+}
+
+MetricsServerWorker::MetricsServerWorker(QObject *parent)
+    : QObject(parent)
+    , m_server(nullptr)
+{
+}
+
+void MetricsServerWorker::listen(quint16 port)
+{
+    if (!m_server) {
+        // 在工作线程中创建，套接字事件由本线程的事件循环处理
+        m_server = new QTcpServer(this);
+        connect(m_server, &QTcpServer::newConnection, this, &MetricsServerWorker::handleNewConnection);
+    }
+    if (m_server->isListening()) {
+        m_server->close();
+    }
+
+    bool ok = m_server->listen(QHostAddress::LocalHost, port);
+    if (!ok) {
+        qWarning() << "Metrics server failed to listen on port" << port << ":" << m_server->errorString();
+    } else {
+        qDebug() << "Metrics server listening on http://127.0.0.1:" << port << "/metrics";
+    }
+    emit listeningChanged(ok, port);
+}
+
+void MetricsServerWorker::shutdown()
+{
+    if (m_server) {
+        m_server->close();
+    }
+    // abort()会同步触发disconnected，先取出连接列表再逐个关闭
+    const QList<QTcpSocket*> sockets = m_requests.keys();
+    m_requests.clear();
+    for (QTcpSocket* socket : sockets) {
+        socket->abort();
+    }
+}
+
+void MetricsServerWorker::handleNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        m_requests.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            handleReadyRead(socket);
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_requests.remove(socket);
+            socket->deleteLater();
+        });
+        // 超时仍未发完请求头的连接直接断开，避免空闲连接无限期占用
+        QTimer::singleShot(RequestIdleTimeoutMs, socket, [this, socket]() {
+            if (m_requests.remove(socket)) {
+                socket->abort();
+                socket->deleteLater();
+            }
+        });
+    }
+}
+
+void MetricsServerWorker::handleReadyRead(QTcpSocket* socket)
+{
+    auto request = m_requests.find(socket);
+    if (request == m_requests.end()) {
+        return; // 已应答，忽略多余数据
+    }
+    request.value() += socket->readAll();
+
+    int headerEnd = request.value().indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        if (request.value().size() > MaxRequestHeaderSize) {
+            respond(socket, "431 Request Header Fields Too Large", QByteArray());
+        }
+        return;
+    }
+
+    // 只解析请求行："GET /metrics HTTP/1.1"
+    QByteArray requestLine = request.value().left(request.value().indexOf("\r\n"));
+    QList<QByteArray> parts = requestLine.split(' ');
+    if (parts.size() < 2 || (parts[0] != "GET" && parts[0] != "HEAD")) {
+        respond(socket, "405 Method Not Allowed", QByteArray());
+        return;
+    }
+    QByteArray path = parts[1];
+    int query = path.indexOf('?');
+    if (query >= 0) {
+        path.truncate(query);
+    }
+    if (path != "/metrics") {
+        respond(socket, "404 Not Found", QByteArray());
+        return;
+    }
+
+    QByteArray body = MetricsRegistry::instance().renderPrometheus();
+    respond(socket, "200 OK", parts[0] == "HEAD" ? QByteArray() : body);
+}
+
+void MetricsServerWorker::respond(QTcpSocket* socket, const QByteArray& status, const QByteArray& body)
+{
+    m_requests.remove(socket);
+
+    QByteArray response;
+    response.reserve(body.size() + 160);
+    response += "HTTP/1.1 " + status + "\r\n";
+    response += "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+
+    socket->write(response);
+    socket->disconnectFromHost(); // 写完后关闭，随后触发disconnected释放套接字
+}
+
+MetricsServer::MetricsServer(QObject *parent)
+    : QObject(parent)
+    , m_workerThread(nullptr)
+    , m_worker(nullptr)
+    , m_listening(false)
+    , m_port(0)
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+    if (m_workerThread) {
+        QMetaObject::invokeMethod(m_worker, &MetricsServerWorker::shutdown, Qt::BlockingQueuedConnection);
+        m_workerThread->quit();
+        m_workerThread->wait();
+    }
+}
+
+void MetricsServer::start(quint16 port)
+{
+    if (!m_workerThread) {
+        m_workerThread = new QThread(this);
+        m_workerThread->setObjectName("MetricsServerThread");
+        m_worker = new MetricsServerWorker();
+        m_worker->moveToThread(m_workerThread);
+        connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
+        connect(m_worker, &MetricsServerWorker::listeningChanged, this, [this](bool listening, quint16 boundPort) {
+            m_listening = listening;
+            emit listeningChanged(listening, boundPort);
+        });
+        m_workerThread->start(QThread::LowPriority);
+    }
+
+    m_port = port;
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, port]() {
+        worker->listen(port);
+    }, Qt::QueuedConnection);
+}
+
+void MetricsServer::stop()
+{
+    if (!m_workerThread) {
+        return;
+    }
+    QMetaObject::invokeMethod(m_worker, &MetricsServerWorker::shutdown, Qt::QueuedConnection);
+    m_listening = false;
+    emit listeningChanged(false, m_port);
+}
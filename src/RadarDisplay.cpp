@@ -1,12 +1,14 @@
 #include "RadarDisplay.h"
+#include "MetricsRegistry.h"
+#include "Tracing.h"
 #include <QPaintEvent>
 #include <QMouseEvent>
 #include <QDebug>
 #include <QDateTime>
-#include <QDataStream>
 #include <QtMath>
 #include <QFont>
-#include <random>
+#include <cmath>
+#include <algorithm>
 
 RadarDisplay::RadarDisplay(QWidget *parent)
     : QWidget(parent)
@@ -16,6 +18,28 @@ RadarDisplay::RadarDisplay(QWidget *parent)
     , m_showTrails(true)
     , m_showInfo(true)
     , m_trailLength(15) // 适中的轨迹长度，保持轨迹可见
+    , m_trailFadeMs(8000)
+    , m_lodThreshold(500)
+    , m_heatmapThreshold(2000)
+    , m_deadReckoning(true)
+    , m_snapDistance(60.0)
+    , m_correctionBlendMs(300)
+    , m_receiverBound(false)
+    , m_skippedRadarFrames(0)
+    , m_lastFrameTime(0)
+    , m_gridCacheDirty(true)
+    , m_renderThread(nullptr)
+    , m_renderWorker(nullptr)
+    , m_backgroundRendering(false)
+    , m_renderInFlight(false)
+    , m_renderPending(false)
+    , m_hitGridDirty(true)
+    , m_hitGridScale(0.0)
+    , m_hitGridTime(0)
+    , m_hitGridMaxSpeed(0.0)
+    , m_hitGridMaxCorrection(0.0)
+    , m_trailArena(15)
+    , m_coastTimeoutMs(6000)
     , m_totalDronesDetected(0)
     , m_lastDataTime(0)
     , m_showStrikeHighlight(false)
@@ -27,6 +51,11 @@ RadarDisplay::RadarDisplay(QWidget *parent)
     , m_hoveredDroneId(-1)
     , m_scanAngle(0)
     , m_radarRunning(true) // 默认雷达运行
+    , m_beamSyncAngle(0.0)
+    , m_beamWidthDegrees(0.0)
+    , m_beamRateDegPerMs(0.0)
+    , m_lastBeamSyncTime(0)
+    , m_beamRotationMs(0)
     , m_connectionStatus("已连接")
     , m_currentDetections(0)
     , m_totalDetections(0)
@@ -40,74 +69,42 @@ RadarDisplay::RadarDisplay(QWidget *parent)
     setWindowTitle("雷达显示器");
     setMouseTracking(true); // 启用鼠标跟踪
 
-    // 网络连接
-    m_udpSocket = new QUdpSocket(this);
-    connect(m_udpSocket, &QUdpSocket::readyRead, this, &RadarDisplay::handleDataReceived);
+    // 网络接收：数据报的读取和解码在独立线程中完成，GUI线程只取解码好的帧
+    m_receiverThread = new QThread(this);
+    m_receiverThread->setObjectName("RadarReceiverThread");
+    m_receiver = new RadarReceiver();
+    m_receiver->moveToThread(m_receiverThread);
+    connect(m_receiverThread, &QThread::finished, m_receiver, &QObject::deleteLater);
+    connect(m_receiver, &RadarReceiver::framesAvailable, this, &RadarDisplay::handleDataReceived);
+    m_receiverThread->start();
 
-    // 定时器
-    m_updateTimer = new QTimer(this);
+    // 数据维护定时器（过期清理、漏扫外推）
     m_cleanupTimer = new QTimer(this);
-    connect(m_updateTimer, &QTimer::timeout, this, &RadarDisplay::updateDisplay);
     connect(m_cleanupTimer, &QTimer::timeout, this, &RadarDisplay::cleanupOldDrones);
-
-    m_updateTimer->start(50);  // 20fps
     m_cleanupTimer->start(500); // 每0.5秒清理一次过期数据，更频繁清理
 
-    // 新增：独立的扫描线角度更新定时器（不触发重绘）
-    m_scanTimer = new QTimer(this);
-    connect(m_scanTimer, &QTimer::timeout, this, [this]() {
-        if (m_radarRunning) { // 只在雷达运行时更新扫描角度
-            m_scanAngle += 2; // 固定频率：2度/帧
-            if (m_scanAngle >= 360) m_scanAngle = 0;
+    // 统一帧调度：扫描线、打击效果等动画在同一节拍中推进，所有重绘请求合并为每帧一次
+    m_frameScheduler = new FrameScheduler(this);
+    connect(m_frameScheduler, &FrameScheduler::frameTick, this, &RadarDisplay::advanceAnimations);
+    connect(m_frameScheduler, &FrameScheduler::frameReady, this, [this]() {
+        if (m_backgroundRendering) {
+            requestBackgroundFrame(); // 渲染完成后再update()贴图
+        } else {
+            update();
         }
-        // 注意：这里不调用update()，让正常的更新定时器处理重绘
     });
-    m_scanTimer->start(50); // 固定20fps，确保扫描线速度恒定
+    connect(m_frameScheduler, &FrameScheduler::fpsUpdated, this, &RadarDisplay::frameRateUpdated);
+    m_frameScheduler->setAnimationActive(SweepAnimation, m_radarRunning);
+    m_frameScheduler->start();
 
     // 打击高亮定时器
     m_strikeHighlightTimer = new QTimer(this);
     m_strikeHighlightTimer->setSingleShot(true);
     connect(m_strikeHighlightTimer, &QTimer::timeout, this, [this]() {
         m_showStrikeHighlight = false;
-        update();
-    });
-
-    // 新增：打击效果定时器
-    m_strikeEffectTimer = new QTimer(this);
-    connect(m_strikeEffectTimer, &QTimer::timeout, this, [this]() {
-        // 更新打击效果动画
-        qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-        for (auto it = m_strikeEffects.begin(); it != m_strikeEffects.end();) {
-            qint64 elapsed = currentTime - it->startTime;
-            if (elapsed >= it->duration) {
-                it = m_strikeEffects.erase(it);
-            } else {
-                // 更新动画参数
-                double progress = double(elapsed) / it->duration;
-                it->currentRadius = it->radius * (1.0 + progress * 0.5); // 扩张效果
-                it->pulsePhase = (it->pulsePhase + 1) % 360;
-
-                // 颜色渐变效果
-                int alpha = qMax(0, int(255 * (1.0 - progress)));
-                it->color.setAlpha(alpha);
-                ++it;
-            }
-        }
-
-        if (m_strikeEffects.isEmpty()) {
-            m_strikeEffectTimer->stop();
-        }
-        update();
+        m_frameScheduler->invalidate();
     });
 
-    // 新增：动画定时器
-    m_animationTimer = new QTimer(this);
-    connect(m_animationTimer, &QTimer::timeout, this, [this]() {
-        m_animationPhase = (m_animationPhase + 1) % 360;
-        update();
-    });
-    m_animationTimer->start(100); // 10fps动画
-
     // 初始化颜色列表
     m_droneColors << QColor(Qt::red) << QColor(Qt::green) << QColor(Qt::blue)
                   << QColor(Qt::yellow) << QColor(Qt::magenta) << QColor(Qt::cyan)
@@ -118,6 +115,12 @@ RadarDisplay::RadarDisplay(QWidget *parent)
 RadarDisplay::~RadarDisplay()
 {
     disconnectFromRadar();
+    m_receiverThread->quit();
+    m_receiverThread->wait();
+    if (m_renderThread) {
+        m_renderThread->quit();
+        m_renderThread->wait();
+    }
 }
 
 void RadarDisplay::connectToRadar(const QString& host, quint16 port)
@@ -125,37 +128,49 @@ void RadarDisplay::connectToRadar(const QString& host, quint16 port)
     m_serverAddress = QHostAddress(host);
     m_serverPort = port;
 
-    // UDP客户端绑定到固定端口12346
+    // UDP客户端绑定到固定端口12346（在接收线程中同步完成）
     quint16 clientPort = 12346;
-    if (m_udpSocket->bind(QHostAddress::LocalHost, clientPort)) {
+    bool bound = false;
+    QMetaObject::invokeMethod(m_receiver, [receiver = m_receiver, clientPort, &bound]() {
+        bound = receiver->bindSocket(QHostAddress::LocalHost, clientPort);
+    }, Qt::BlockingQueuedConnection);
+    m_receiverBound = bound;
+
+    if (bound) {
         qDebug() << "UDP client bound successfully to port" << clientPort
                  << "to communicate with" << host << ":" << port;
-
         emit connectionStatusChanged(true);
     } else {
-        qDebug() << "Failed to bind UDP socket to port" << clientPort << ":" << m_udpSocket->errorString();
         emit connectionStatusChanged(false);
     }
 }
 
 void RadarDisplay::disconnectFromRadar()
 {
-    if (m_udpSocket) {
-        m_udpSocket->close();
+    if (m_receiverBound) {
+        QMetaObject::invokeMethod(m_receiver, &RadarReceiver::closeSocket, Qt::BlockingQueuedConnection);
+        m_receiverBound = false;
         qDebug() << "UDP socket closed";
     }
 }
 
 bool RadarDisplay::isConnected() const
 {
-    return m_udpSocket && m_udpSocket->state() == QAbstractSocket::BoundState;
+    return m_receiverBound;
 }
 
 void RadarDisplay::clearDisplay()
 {
     m_drones.clear();
+    m_droneIndex.clear();
+    m_trailArena.releaseAll();
+    m_heatmap.clear();
+    m_hitGridDirty = true;
+    m_frameScheduler->setAnimationActive(MotionAnimation, false);
+    m_trackerBank.clear();
+    m_lastFrameTime = 0;
     m_totalDronesDetected = 0;
-    update();
+    m_frameScheduler->invalidate();
 }
 
 void RadarDisplay::highlightStrikeArea(QPointF center, double radius)
@@ -166,7 +181,7 @@ void RadarDisplay::highlightStrikeArea(QPointF center, double radius)
 
     // 3秒后自动隐藏高亮
     m_strikeHighlightTimer->start(3000);
-    update();
+    m_frameScheduler->invalidate();
 }
 
 // 新增：带动画的打击高亮
@@ -190,20 +205,18 @@ void RadarDisplay::addStrikeEffect(QPointF center, double radius)
 
     m_strikeEffects.append(effect);
 
-    if (!m_strikeEffectTimer->isActive()) {
-        m_strikeEffectTimer->start(50); // 恢复原来的频率
-    }
+    m_frameScheduler->setAnimationActive(StrikeEffectAnimation, true);
 
-    // 立即触发一次绘制以显示即时效果
-    update();
+    // 下一帧立即显示效果
+    m_frameScheduler->invalidate();
 }
 
 // 新增：清除打击效果
 void RadarDisplay::clearStrikeEffects()
 {
     m_strikeEffects.clear();
-    m_strikeEffectTimer->stop();
-    update();
+    m_frameScheduler->setAnimationActive(StrikeEffectAnimation, false);
+    m_frameScheduler->invalidate();
 }
 
 // 新增：设置状态信息
@@ -219,7 +232,7 @@ void RadarDisplay::setStatusInfo(const QString& connectionStatus, int currentDet
     m_systemStatus = systemStatus;
     m_droneCount = droneCount;
     m_radarStatus = radarStatus;
-    update(); // 触发重绘
+    m_frameScheduler->invalidate(); // 触发重绘
 }
 
 // 新增：设置打击模式
@@ -232,28 +245,21 @@ void RadarDisplay::setStrikeMode(bool enabled)
         setCursor(Qt::ArrowCursor);
         m_showMouseCursor = false;
     }
-    update();
+    m_frameScheduler->invalidate();
 }
 
 void RadarDisplay::paintEvent(QPaintEvent* event)
 {
     Q_UNUSED(event)
+    RADAR_TRACE_SCOPE("RadarDisplay::paintEvent");
 
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+    updateScaleFactor();
 
-    // 设置背景
-    painter.fillRect(rect(), QColor(0, 20, 0));
+    // 静态背景层直接贴图，帧开销只与动态内容相关
+    ensureGridCache();
 
-    // 计算缩放因子
-    int minDimension = qMin(width(), height()) - 20;
-    m_scaleFactor = minDimension / (2.0 * m_radarRadius);
-
-    // 设置坐标系原点到中心
-    painter.translate(width() / 2, height() / 2);
-
-    // 绘制雷达网格
-    drawRadarGrid(painter);
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, m_gridCache);
 
     // 调试信息：显示无人机数量
     static int paintCount = 0;
@@ -261,17 +267,22 @@ void RadarDisplay::paintEvent(QPaintEvent* event)
         qDebug() << "PAINT EVENT: Drawing" << m_drones.size() << "drones. Scale factor:" << m_scaleFactor;
     }
 
-    // 绘制无人机
-    drawDrones(painter);
+    if (m_backgroundRendering) {
+        // 动态图层已由渲染线程光栅化，这里只贴图
+        m_renderWorker->presentFrame(painter);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.translate(width() / 2, height() / 2);
+    } else {
+        painter.setRenderHint(QPainter::Antialiasing);
+
+        // 设置坐标系原点到中心
+        painter.translate(width() / 2, height() / 2);
 
-    // 绘制打击高亮
-    if (m_showStrikeHighlight) {
-        drawStrikeHighlight(painter);
+        // 扫描线、轨迹、目标和打击效果
+        buildScene(m_scene);
+        m_sceneRenderer.render(painter, m_scene);
     }
 
-    // 绘制动画打击效果
-    drawStrikeEffects(painter);
-
     // 绘制鼠标光标（打击模式下）
     if (m_strikeMode && m_showMouseCursor) {
         drawStrikeCursor(painter);
@@ -329,13 +340,186 @@ void RadarDisplay::paintEvent(QPaintEvent* event)
     if (m_lastDataTime > 0) {
         qint64 elapsed = QDateTime::currentMSecsSinceEpoch() - m_lastDataTime;
         painter.drawText(10, y, QString("最后更新: %1 秒前").arg(elapsed / 1000.0, 0, 'f', 1));
+        y += 20;
     }
+    painter.drawText(10, y, QString("帧率: %1 FPS").arg(m_frameScheduler->getActualFps(), 0, 'f', 1));
+
+    m_frameScheduler->framePresented();
 }
 
 void RadarDisplay::resizeEvent(QResizeEvent* event)
 {
     Q_UNUSED(event)
+    invalidateGridCache();
+    m_frameScheduler->invalidate();
+}
+
+void RadarDisplay::setRadarRadius(double radius)
+{
+    m_radarRadius = radius;
+    invalidateGridCache(); // 距离标签和缩放随半径变化
+    m_frameScheduler->invalidate();
+}
+
+void RadarDisplay::ensureGridCache()
+{
+    // 按设备像素比创建缓存，高分屏下保持清晰
+    const qreal pixelRatio = devicePixelRatioF();
+    const QSize pixelSize = size() * pixelRatio;
+    if (!m_gridCacheDirty && m_gridCache.size() == pixelSize
+        && qFuzzyCompare(m_gridCache.devicePixelRatio(), pixelRatio)) {
+        return;
+    }
+
+    m_gridCache = QPixmap(pixelSize);
+    m_gridCache.setDevicePixelRatio(pixelRatio);
+    m_gridCache.fill(QColor(0, 20, 0)); // 背景色
+
+    QPainter cachePainter(&m_gridCache);
+    cachePainter.setRenderHint(QPainter::Antialiasing);
+    cachePainter.translate(width() / 2, height() / 2);
+    drawRadarGrid(cachePainter);
+    cachePainter.end();
+
+    m_gridCacheDirty = false;
+}
+
+void RadarDisplay::updateScaleFactor()
+{
+    // 计算缩放因子
+    int minDimension = qMin(width(), height()) - 20;
+    m_scaleFactor = minDimension / (2.0 * m_radarRadius);
+}
+
+void RadarDisplay::buildScene(RadarScene& scene)
+{
+    const qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+
+    scene.size = size();
+    scene.devicePixelRatio = devicePixelRatioF();
+    scene.scaleFactor = m_scaleFactor;
+    scene.radarRadius = m_radarRadius;
+    scene.time = currentTime;
+    scene.radarRunning = m_radarRunning;
+    scene.scanAngle = m_scanAngle;
+    scene.showTrails = m_showTrails;
+    scene.showInfo = m_showInfo;
+    scene.spriteMode = m_drones.size() > m_lodThreshold;
+    scene.heatmapMode = m_drones.size() > m_heatmapThreshold;
+    scene.heatmap = QImage(); // 先释放上一帧的引用，热力图重建时不必复制
+    if (scene.heatmapMode) {
+        scene.heatmap = m_heatmap.image();
+    }
+    scene.laserTargetIndex = m_droneIndex.value(m_laserTargetId, -1);
+    scene.trailFadeMs = m_trailFadeMs;
+    scene.showStrikeHighlight = m_showStrikeHighlight;
+    scene.strikeCenter = m_strikeCenter;
+    scene.strikeRadius = m_strikeRadius;
+
+    // 目标按m_drones的顺序复制，laserTargetIndex可直接沿用索引表
+    scene.drones.resize(m_drones.size());
+    scene.trailPoints.clear();
+    for (int i = 0; i < m_drones.size(); ++i) {
+        const DisplayDrone& drone = m_drones[i];
+        RenderDrone& item = scene.drones[i];
+
+        item.id = drone.id;
+        item.position = drone.renderPosition;
+        item.color = drone.color.rgb();
+        item.coasting = drone.coasting;
+        item.distance = drone.distance; // 直接使用 drone.distance，这是从 RadarSimulator 正确计算的距离
+
+        // 根据方向旋转三角形
+        item.angle = 0.0;
+        if (drone.useNewTrajectory) {
+            // 新轨迹系统：使用实际运动方向，+90度因为三角形默认向上
+            item.angle = drone.currentDirection + M_PI / 2;
+        } else if (drone.velocity.manhattanLength() > 0) {
+            // 旧系统：根据速度方向
+            item.angle = qAtan2(drone.velocity.x(), -drone.velocity.y());
+        }
+
+        if (drone.useNewTrajectory && drone.currentSpeed > 0) {
+            // 新轨迹系统：使用实际物理速度
+            item.speed = drone.currentSpeed;
+        } else {
+            // 旧系统：计算速度向量大小
+            item.speed = qSqrt(drone.velocity.x() * drone.velocity.x() + drone.velocity.y() * drone.velocity.y());
+        }
+
+        // 轨迹点展开到一块连续数组，从最老的点开始
+        item.trailBegin = scene.trailPoints.size();
+        item.trailCount = (m_showTrails && !scene.heatmapMode) ? m_trailArena.count(drone.trailSlot) : 0;
+        for (int j = 0; j < item.trailCount; ++j) {
+            scene.trailPoints.append(m_trailArena.at(drone.trailSlot, j));
+        }
+    }
+
+    scene.strikeEffects.clear();
+    for (const StrikeEffect& effect : m_strikeEffects) {
+        qint64 elapsed = currentTime - effect.startTime;
+        if (elapsed >= effect.duration) {
+            continue; // 动画结束，由advanceAnimations()移除
+        }
+        RenderStrikeEffect item;
+        item.center = effect.center;
+        item.radius = effect.radius;
+        item.progress = static_cast<double>(elapsed) / effect.duration;
+        item.pulsePhase = effect.pulsePhase;
+        scene.strikeEffects.append(item);
+    }
+}
+
+void RadarDisplay::setBackgroundRendering(bool enabled)
+{
+    if (enabled == m_backgroundRendering) {
+        return;
+    }
+
+    if (enabled && !m_renderThread) {
+        // 渲染线程按需创建，默认在GUI线程直接绘制
+        m_renderThread = new QThread(this);
+        m_renderThread->setObjectName("RadarRenderThread");
+        m_renderWorker = new RadarRenderWorker();
+        m_renderWorker->moveToThread(m_renderThread);
+        connect(m_renderThread, &QThread::finished, m_renderWorker, &QObject::deleteLater);
+        connect(m_renderWorker, &RadarRenderWorker::frameRendered, this, &RadarDisplay::handleFrameRendered);
+        m_renderThread->start();
+    }
+
+    m_backgroundRendering = enabled;
+    m_renderPending = false;
+    if (enabled) {
+        requestBackgroundFrame();
+    }
+    m_frameScheduler->invalidate();
+}
+
+void RadarDisplay::requestBackgroundFrame()
+{
+    // 渲染线程同一时间只处理一帧，忙时只记下请求，完成后用最新状态再画一帧
+    if (m_renderInFlight) {
+        m_renderPending = true;
+        return;
+    }
+
+    updateScaleFactor();
+    buildScene(m_scene);
+    m_renderInFlight = true;
+    QMetaObject::invokeMethod(m_renderWorker, [worker = m_renderWorker, scene = m_scene]() {
+        worker->renderScene(scene);
+    }, Qt::QueuedConnection);
+}
+
+void RadarDisplay::handleFrameRendered()
+{
+    m_renderInFlight = false;
     update();
+
+    if (m_renderPending && m_backgroundRendering) {
+        m_renderPending = false;
+        requestBackgroundFrame();
+    }
 }
 
 void RadarDisplay::mousePressEvent(QMouseEvent* event)
@@ -364,17 +548,14 @@ void RadarDisplay::mousePressEvent(QMouseEvent* event)
     }
 
     // 查找点击的无人机
-    for (const DisplayDrone& drone : m_drones) {
-        QPointF droneScreenPos = worldToScreen(drone.position);
-        double distance = QPointF(screenPos - droneScreenPos).manhattanLength();
-        if (distance < 20) { // 20像素容忍度
-            qDebug() << "Clicked on drone" << drone.id << "at position" << drone.position;
-            emit droneClicked(drone.id, drone.position);
-
-            // 高亮选中的无人机
-            highlightStrikeAreaWithAnimation(drone.position, 30.0);
-            break;
-        }
+    int index = hitTestDrone(screenPos, 20); // 20像素容忍度
+    if (index >= 0) {
+        const DisplayDrone& drone = m_drones[index];
+        qDebug() << "Clicked on drone" << drone.id << "at position" << drone.renderPosition;
+        emit droneClicked(drone.id, drone.renderPosition);
+
+        // 高亮选中的无人机
+        highlightStrikeAreaWithAnimation(drone.renderPosition, 30.0);
     }
 }
 
@@ -389,24 +570,22 @@ void RadarDisplay::mouseMoveEvent(QMouseEvent* event)
         // 检查是否在雷达范围内
         double distanceFromCenter = qSqrt(worldPos.x() * worldPos.x() + worldPos.y() * worldPos.y());
         m_showMouseCursor = (distanceFromCenter <= m_radarRadius);
-        update();
+        m_frameScheduler->invalidate();
     } else {
         // 检查是否hover在无人机上
         int previousHovered = m_hoveredDroneId;
         m_hoveredDroneId = -1;
 
-        for (const DisplayDrone& drone : m_drones) {
-            QPointF droneScreenPos = worldToScreen(drone.position);
-            double distance = QPointF(screenPos - droneScreenPos).manhattanLength();
-            if (distance < 25) { // 25像素hover容忍度
-                m_hoveredDroneId = drone.id;
-                m_hoveredDronePosition = drone.position;
-                break;
-            }
+        int index = hitTestDrone(screenPos, 25); // 25像素hover容忍度
+        if (index >= 0) {
+            m_hoveredDroneId = m_drones[index].id;
+            m_hoveredDronePosition = m_drones[index].renderPosition;
         }
 
         if (previousHovered != m_hoveredDroneId) {
-            update(); // 只在hover状态改变时重绘
+            // hover期间脉冲动画需要持续重绘
+            m_frameScheduler->setAnimationActive(HoverAnimation, m_hoveredDroneId != -1);
+            m_frameScheduler->invalidate(); // 只在hover状态改变时重绘
         }
     }
 }
@@ -417,140 +596,144 @@ void RadarDisplay::leaveEvent(QEvent* event)
     Q_UNUSED(event)
     m_showMouseCursor = false;
     m_hoveredDroneId = -1;
-    update();
+    m_frameScheduler->setAnimationActive(HoverAnimation, false);
+    m_frameScheduler->invalidate();
 }
 
 void RadarDisplay::handleDataReceived()
 {
-    qDebug() << "=== UDP DATA RECEIVED ===";
-    qDebug() << "Pending datagrams:" << m_udpSocket->pendingDatagramSize();
-
-    while (m_udpSocket->hasPendingDatagrams()) {
-        QByteArray datagram;
-        datagram.resize(m_udpSocket->pendingDatagramSize());
-        QHostAddress sender;
-        quint16 senderPort;
-
-        qint64 bytesRead = m_udpSocket->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
-        qDebug() << "Received" << bytesRead << "bytes from" << sender.toString() << ":" << senderPort;
-
-        // 处理接收到的数据
-        QDataStream stream(datagram);
-        stream.setVersion(QDataStream::Qt_5_15);
-
-        quint32 magic, version;
-        stream >> magic >> version;
-
-        qDebug() << "Magic:" << QString("0x%1").arg(magic, 8, 16, QChar('0'))
-                 << "Version:" << version;
+    RADAR_TRACE_SCOPE("RadarDisplay::handleDataReceived");
+    // 先确认通知，之后到达的帧会再次触发本函数
+    m_receiver->acknowledgeFrames();
+
+    static MetricCounter* skippedFrames = MetricsRegistry::instance().counter(
+        "radar_display_skipped_frames_total", "Full radar frames superseded before the display applied them");
+
+    RadarFrameQueue& queue = m_receiver->queue();
+    const int count = queue.available();
+    // 队列满时接收线程把帧写入溢出槽；溢出帧可能在槽中停留到队列腾空之后，
+    // 因此不能按来源判断新旧，统一按帧时间戳排序
+    const RadarFrame* overflow = queue.takeOverflow();
+    if (count == 0 && !overflow) {
+        return;
+    }
 
-        if (magic != 0x52444152) { // "RDAR"
-            qWarning() << "Invalid magic number, discarding datagram";
-            continue;
+    m_pendingFrames.clear();
+    for (int i = 0; i < count; ++i) {
+        m_pendingFrames.append(&queue.peek(i));
+    }
+    if (overflow) {
+        m_pendingFrames.append(overflow);
+    }
+    std::stable_sort(m_pendingFrames.begin(), m_pendingFrames.end(),
+                     [](const RadarFrame* a, const RadarFrame* b) { return a->timestamp < b->timestamp; });
+
+    // 全量帧只需处理最新一帧；扇区帧各自覆盖不同扇区，按时间顺序全部处理
+    int newestFullFrame = -1;
+    for (int i = 0; i < m_pendingFrames.size(); ++i) {
+        if (!m_pendingFrames[i]->isSectorFrame()) {
+            newestFullFrame = i;
         }
+    }
 
-        if (version != 1) {
-            qWarning() << "Unsupported version:" << version;
+    for (int i = 0; i < m_pendingFrames.size(); ++i) {
+        const RadarFrame& frame = *m_pendingFrames[i];
+        if (!frame.isSectorFrame() && i != newestFullFrame) {
+            ++m_skippedRadarFrames; // 界面滞后，跳过被更新帧取代的旧帧
+            skippedFrames->add();
             continue;
         }
+        applyRadarFrame(frame);
+    }
+    m_pendingFrames.clear();
+    queue.consume(count);
+}
 
-        qint64 timestamp;
-        quint32 droneCount;
-        stream >> timestamp >> droneCount;
-
-        qDebug() << "Timestamp:" << timestamp << "DroneCount:" << droneCount;
-
-        // 解析无人机数据
-        QList<RadarDetection> detections;
-        for (quint32 i = 0; i < droneCount; ++i) {
-            RadarDetection detection;
-            stream >> detection.droneId >> detection.position >> detection.velocity
-                   >> detection.detectionTime >> detection.distance >> detection.azimuth;
-            
-            // 读取轨迹系统信息
-            quint32 trajectoryTypeInt, speedTypeInt;
-            stream >> trajectoryTypeInt >> speedTypeInt >> detection.currentDirection >> detection.currentSpeed >> detection.useNewTrajectory;
-            detection.trajectoryType = static_cast<TrajectoryType>(trajectoryTypeInt);
-            detection.speedType = static_cast<SpeedType>(speedTypeInt);
-            
-            detections.append(detection);
+void RadarDisplay::applyRadarFrame(const RadarFrame& frame)
+{
+    // 比已应用的帧更旧（上一轮残留在溢出槽中的帧）不再应用，避免航迹和波束回跳
+    if (frame.timestamp < m_lastFrameTime) {
+        ++m_skippedRadarFrames;
+        return;
+    }
+    m_lastFrameTime = frame.timestamp;
 
-            qDebug() << "Parsed drone" << detection.droneId
-                     << "at" << detection.position
-                     << "distance" << detection.distance;
-        }
+    if (frame.isSectorFrame()) {
+        syncBeamAngle(frame.beamStart, frame.beamWidth, frame.sectorIndex, frame.sectorCount);
+    }
 
-        qDebug() << "*** Processing" << detections.size() << "detections ***";
-        // 处理接收到的数据
-        processRadarData(detections);
+    processRadarData(frame.detections);
+    if (frame.timestamp > 0) {
+        emit radarFrameDisplayed(QDateTime::currentMSecsSinceEpoch() - frame.timestamp);
     }
 }
 
 void RadarDisplay::processRadarData(const QList<RadarDetection>& detections)
 {
-    qDebug() << "=== PROCESSING RADAR DATA ===";
-    qDebug() << "Input detections:" << detections.size();
-    qDebug() << "Current drones in display:" << m_drones.size();
+    // 整帧批量更新滤波器，显示使用滤波后的位置和速度
+    m_trackerBank.update(detections);
+    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
 
     // 更新无人机数据
     for (const RadarDetection& detection : detections) {
-        bool found = false;
-        for (DisplayDrone& drone : m_drones) {
-            if (drone.id == detection.droneId) {
-                // 更新现有无人机
-                QPointF oldPosition = drone.position;
-                drone.position = detection.position;
-                 drone.velocity = detection.velocity;
-                if (m_showTrails && oldPosition != detection.position) {
-                    // 只在位置有足够变化时才添加轨迹点
-                    bool shouldAddTrail = false;
-                    if (drone.trail.isEmpty()) {
-                        shouldAddTrail = true;
-                        drone.trail.append(oldPosition); // 添加起始位置
-                    } else {
-                        QPointF lastPos = drone.trail.last();
-                        double distance = qSqrt(qPow(oldPosition.x() - lastPos.x(), 2) +
-                                              qPow(oldPosition.y() - lastPos.y(), 2));
-                        shouldAddTrail = distance > 5.0; // 降低移动距离阈值，让轨迹更容易添加
-                    }
-
-                    if (shouldAddTrail) {
-                        drone.trail.append(oldPosition);
-                        if (drone.trail.size() > m_trailLength) {
-                            drone.trail.removeFirst();
-                        }
-                    }
+        auto index = m_droneIndex.constFind(detection.droneId);
+        if (index != m_droneIndex.constEnd()) {
+            DisplayDrone& drone = m_drones[index.value()];
+            // 更新现有无人机：记下当前屏幕上的外推位置，用于平滑修正
+            QPointF shownPosition = extrapolatePosition(drone, currentTime);
+            QPointF oldPosition = drone.position;
+            drone.position = m_trackerBank.filteredPosition(detection.droneId);
+            drone.coasting = false;
+            if (m_showTrails && oldPosition != drone.position) {
+                // 只在位置有足够变化时才添加轨迹点
+                bool shouldAddTrail = false;
+                if (m_trailArena.isEmpty(drone.trailSlot)) {
+                    shouldAddTrail = true; // 添加起始位置
+                } else {
+                    QPointF lastPos = m_trailArena.last(drone.trailSlot).position;
+                    double distance = qSqrt(qPow(oldPosition.x() - lastPos.x(), 2) +
+                                          qPow(oldPosition.y() - lastPos.y(), 2));
+                    shouldAddTrail = distance > 5.0; // 降低移动距离阈值，让轨迹更容易添加
                 }
-                drone.velocity = detection.velocity;
-                drone.lastUpdateTime = detection.detectionTime;
-                drone.distance = detection.distance;
-                drone.azimuth = detection.azimuth;
-                
-                // 根据威胁值更新颜色（将像素坐标转换为实际距离）
-                double pixelDistance = qSqrt(detection.position.x() * detection.position.x() + 
-                                           detection.position.y() * detection.position.y());
-                double distanceToCenter = pixelDistance * m_scaleFactor; // 转换为实际距离（米）
-                double threatScore = 1000.0 / qMax(1.0, distanceToCenter);
-                drone.color = getThreatBasedColor(threatScore);
-                
-                // 更新轨迹系统信息
-                drone.trajectoryType = detection.trajectoryType;
-                drone.speedType = detection.speedType;
-                drone.currentDirection = detection.currentDirection;
-                drone.currentSpeed = detection.currentSpeed;
-                drone.useNewTrajectory = detection.useNewTrajectory;
-                
-                found = true;
-                qDebug() << "Updated existing drone" << drone.id << "at" << drone.position;
-                break;
-            }
-        }
 
-        if (!found) {
+                if (shouldAddTrail) {
+                    // 环形槽位已满时自动覆盖最老的点
+                    m_trailArena.append(drone.trailSlot, oldPosition, currentTime);
+                }
+            }
+            drone.velocity = m_trackerBank.filteredVelocity(detection.droneId);
+            drone.lastUpdateTime = detection.detectionTime;
+            drone.distance = detection.distance;
+            drone.azimuth = detection.azimuth;
+            
+            // 根据威胁值更新颜色（将像素坐标转换为实际距离）
+            double pixelDistance = qSqrt(detection.position.x() * detection.position.x() + 
+                                       detection.position.y() * detection.position.y());
+            double distanceToCenter = pixelDistance * m_scaleFactor; // 转换为实际距离（米）
+            double threatScore = 1000.0 / qMax(1.0, distanceToCenter);
+            drone.color = getThreatBasedColor(threatScore);
+            
+            // 更新轨迹系统信息
+            drone.trajectoryType = detection.trajectoryType;
+            drone.speedType = detection.speedType;
+            drone.currentDirection = detection.currentDirection;
+            drone.currentSpeed = detection.currentSpeed;
+            drone.useNewTrajectory = detection.useNewTrajectory;
+            
+            // 新帧到达：偏差较小时在短时间内平滑过渡，偏差过大直接跳到新位置
+            drone.correctionStartTime = 0;
+            QPointF offset = shownPosition - extrapolatePosition(drone, currentTime);
+            if (m_deadReckoning && offset.manhattanLength() < m_snapDistance) {
+                drone.correctionOffset = offset;
+                drone.correctionStartTime = currentTime;
+            }
+            drone.renderPosition = extrapolatePosition(drone, currentTime);
+        } else {
             // 新的无人机
             DisplayDrone drone;
             drone.id = detection.droneId;
             drone.position = detection.position;
+            drone.renderPosition = detection.position;
             drone.velocity = detection.velocity;
             drone.lastUpdateTime = detection.detectionTime;
             drone.distance = detection.distance;
@@ -571,62 +754,235 @@ void RadarDisplay::processRadarData(const QList<RadarDetection>& detections)
             drone.useNewTrajectory = detection.useNewTrajectory;
 
             // 为新无人机初始化轨迹
+            drone.trailSlot = m_trailArena.allocate();
             if (m_showTrails) {
-                drone.trail.append(detection.position);
+                m_trailArena.append(drone.trailSlot, detection.position, currentTime);
             }
 
+            m_droneIndex.insert(drone.id, m_drones.size());
             m_drones.append(drone);
             m_totalDronesDetected++;
-            qDebug() << "Added NEW drone" << drone.id << "at" << drone.position << "color" << drone.color.name();
         }
     }
 
-    qDebug() << "Total drones after processing:" << m_drones.size();
+    m_hitGridDirty = true;
+    m_frameScheduler->setAnimationActive(MotionAnimation, m_deadReckoning && !m_drones.isEmpty());
 
     m_lastDataTime = QDateTime::currentMSecsSinceEpoch();
     emit droneDataReceived(detections.size());
 
-    // 强制重绘显示
-    update();
-    qDebug() << "=== RADAR DATA PROCESSING COMPLETE ===";
+    // 下一帧重绘显示
+    m_frameScheduler->invalidate();
 }
 
-void RadarDisplay::updateDisplay()
+void RadarDisplay::advanceAnimations(qint64 elapsedMs)
 {
-    update();
+    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+
+    // 扫描线角度
+    if (m_radarRunning) { // 只在雷达运行时更新扫描角度
+        if (m_lastBeamSyncTime > 0 && currentTime - m_lastBeamSyncTime < 2000) {
+            // 已与服务器波束同步：按估计角速度外推，但不越过当前扇区的终点
+            double advance = qMin(m_beamWidthDegrees, m_beamRateDegPerMs * (currentTime - m_lastBeamSyncTime));
+            m_scanAngle = std::fmod(m_beamSyncAngle + advance, 360.0);
+        } else {
+            // 固定角速度：40度/秒，与帧率无关
+            m_scanAngle = std::fmod(m_scanAngle + 0.04 * elapsedMs, 360.0);
+        }
+    }
+
+    // 打击效果动画
+    for (auto it = m_strikeEffects.begin(); it != m_strikeEffects.end();) {
+        qint64 elapsed = currentTime - it->startTime;
+        if (elapsed >= it->duration) {
+            it = m_strikeEffects.erase(it);
+        } else {
+            // 更新动画参数
+            double progress = double(elapsed) / it->duration;
+            it->currentRadius = it->radius * (1.0 + progress * 0.5); // 扩张效果
+            it->pulsePhase = int(elapsed / 50) % 360;
+
+            // 颜色渐变效果
+            int alpha = qMax(0, int(255 * (1.0 - progress)));
+            it->color.setAlpha(alpha);
+            ++it;
+        }
+    }
+    if (m_strikeEffects.isEmpty()) {
+        m_frameScheduler->setAnimationActive(StrikeEffectAnimation, false);
+    }
+
+    m_animationPhase = int(currentTime / 100) % 360;
+
+    // 航位推算：每帧把所有目标外推到当前时刻
+    if (m_deadReckoning && !m_drones.isEmpty()) {
+        for (DisplayDrone& drone : m_drones) {
+            drone.renderPosition = extrapolatePosition(drone, currentTime);
+            if (drone.id == m_hoveredDroneId) {
+                m_hoveredDronePosition = drone.renderPosition;
+            }
+        }
+    }
+
+    // 密度热力图：目标数超过阈值时每帧衰减一次再累加当前位置
+    const bool heatmapActive = m_drones.size() > m_heatmapThreshold;
+    if (heatmapActive) {
+        m_heatmap.configure(m_radarRadius * m_scaleFactor, m_radarRadius);
+        m_heatmap.decay(elapsedMs);
+        for (const DisplayDrone& drone : m_drones) {
+            m_heatmap.accumulate(drone.renderPosition);
+        }
+    } else if (!m_heatmap.isEmpty()) {
+        m_heatmap.clear();
+    }
+    m_frameScheduler->setAnimationActive(HeatmapAnimation, heatmapActive); // 衰减过程需要连续重绘
+}
+
+void RadarDisplay::setDeadReckoning(bool enabled)
+{
+    m_deadReckoning = enabled;
+    if (!enabled) {
+        // 关闭后回到最近一次定位位置
+        for (DisplayDrone& drone : m_drones) {
+            drone.renderPosition = drone.position;
+            drone.correctionStartTime = 0;
+        }
+        m_hitGridDirty = true;
+    }
+    m_frameScheduler->setAnimationActive(MotionAnimation, m_deadReckoning && !m_drones.isEmpty());
+    m_frameScheduler->invalidate();
+}
+
+QPointF RadarDisplay::extrapolatePosition(const DisplayDrone& drone, qint64 time) const
+{
+    if (!m_deadReckoning) {
+        return drone.position;
+    }
+
+    // 外推时长不超过外推时限，超过后目标会被清理
+    double dt = qBound<qint64>(0, time - drone.lastUpdateTime, m_coastTimeoutMs) / 1000.0;
+
+    QPointF velocity = drone.velocity;
+    if (drone.useNewTrajectory && drone.currentSpeed > 0) {
+        // 新轨迹系统：按实际运动方向和速度外推
+        velocity = QPointF(qCos(drone.currentDirection), qSin(drone.currentDirection)) * drone.currentSpeed;
+    }
+    QPointF position = drone.position + velocity * dt;
+
+    // 修正量线性衰减，避免新帧到达时图标跳变
+    if (drone.correctionStartTime > 0 && m_correctionBlendMs > 0) {
+        double remaining = 1.0 - double(time - drone.correctionStartTime) / m_correctionBlendMs;
+        if (remaining > 0.0) {
+            position += drone.correctionOffset * qMin(1.0, remaining);
+        }
+    }
+    return position;
 }
 
 void RadarDisplay::cleanupOldDrones()
 {
     qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    const qint64 timeoutMs = 2000; // 2秒超时，给目标足够的显示时间
+    // 超过1.5秒未更新视为漏扫，按滤波速度外推；旋转波束模式下以1.5圈为准
+    const qint64 missedScanMs = qMax<qint64>(1500, m_beamRotationMs * 3 / 2);
+    // 外推超过时限仍未重新检测到才删除目标
+    const qint64 coastTimeoutMs = qMax<qint64>(m_coastTimeoutMs, m_beamRotationMs * 3);
+
+    bool changed = false;
+    // 航迹是否过期由跟踪器组按最后一次量测时间判定，显示列表随之删除对应目标
+    const QList<int> expired = m_trackerBank.removeStale(currentTime, coastTimeoutMs);
+    for (int id : expired) {
+        int index = m_droneIndex.value(id, -1);
+        if (index >= 0) {
+            qDebug() << "Removing expired drone" << id;
+            removeDroneAt(index);
+            changed = true;
+        }
+    }
 
     for (int i = m_drones.size() - 1; i >= 0; --i) {
-        if (currentTime - m_drones[i].lastUpdateTime > timeoutMs) {
-            qDebug() << "Removing expired drone" << m_drones[i].id;
-            // 清除轨迹
-            m_drones[i].trail.clear();
-            m_drones.removeAt(i);
-        } else {
-            // 即使无人机还在，也要让轨迹逐渐缩短
-            DisplayDrone& drone = m_drones[i];
-            if (!drone.trail.isEmpty() && drone.trail.size() > 8) {
-                // 只有当轨迹很长时才偶尔清理
-                static std::random_device rd;
-                static std::mt19937 gen(rd());
-                static std::uniform_int_distribution<> dis(0, 9);
-                if (dis(gen) == 0) { // 10%的概率移除最老的轨迹点
-                    drone.trail.removeFirst();
-                }
+        qint64 sinceUpdate = currentTime - m_drones[i].lastUpdateTime;
+        if (sinceUpdate > missedScanMs) {
+            if (!m_deadReckoning) {
+                // 未启用航位推算时由滤波器给出外推位置
+                m_drones[i].position = m_trackerBank.predictPosition(m_drones[i].id, currentTime);
+                m_drones[i].renderPosition = m_drones[i].position;
             }
+            m_drones[i].coasting = true;
+            m_hitGridDirty = true;
+            changed = true;
         }
+
+        // 即使无人机还在，超过存活时间的轨迹点也会被丢弃
+        m_trailArena.expire(m_drones[i].trailSlot, currentTime - m_trailFadeMs);
+    }
+
+    if (changed) {
+        m_frameScheduler->setAnimationActive(MotionAnimation, m_deadReckoning && !m_drones.isEmpty());
+        m_frameScheduler->invalidate();
     }
 }
 
-void RadarDisplay::parseRadarData(const QByteArray& data)
+void RadarDisplay::removeDroneAt(int index)
 {
-    Q_UNUSED(data)
-    // 数据已在 handleDataReceived 中解析
+    // 交换删除：最后一个元素移到空位，只需修正它的索引
+    int last = m_drones.size() - 1;
+    m_droneIndex.remove(m_drones[index].id);
+    m_trailArena.release(m_drones[index].trailSlot);
+    if (index != last) {
+        m_drones[index] = std::move(m_drones[last]);
+        m_droneIndex[m_drones[index].id] = index;
+    }
+    m_drones.removeLast();
+    m_hitGridDirty = true;
+}
+
+int RadarDisplay::hitTestDrone(QPointF widgetPos, double tolerance)
+{
+    // 屏幕空间网格只在目标增删、新帧到达或缩放变化后重建，航位推算的逐帧移动不触发重建：
+    // 之后目标偏离网格位置不超过 最大速度×经过时间+修正量，按此放宽半径取候选，再用当前绘制位置判断
+    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+    if (m_hitGridDirty || m_hitGridScale != m_scaleFactor) {
+        m_hitGrid.setCellSize(50.0);
+        m_hitGridMaxSpeed = 0.0;
+        m_hitGridMaxCorrection = 0.0;
+        for (int i = 0; i < m_drones.size(); ++i) {
+            const DisplayDrone& drone = m_drones[i];
+            m_hitGrid.insert(i, worldToScreen(drone.renderPosition));
+            double speed = drone.useNewTrajectory && drone.currentSpeed > 0
+                               ? drone.currentSpeed
+                               : qSqrt(QPointF::dotProduct(drone.velocity, drone.velocity));
+            m_hitGridMaxSpeed = qMax(m_hitGridMaxSpeed, speed);
+            if (drone.correctionStartTime > 0) {
+                m_hitGridMaxCorrection = qMax(m_hitGridMaxCorrection,
+                    qSqrt(QPointF::dotProduct(drone.correctionOffset, drone.correctionOffset)));
+            }
+        }
+        m_hitGridScale = m_scaleFactor;
+        m_hitGridTime = currentTime;
+        m_hitGridDirty = false;
+    }
+
+    QPointF centeredPos = widgetPos - QPointF(width() / 2, height() / 2);
+    double drift = 0.0;
+    if (m_deadReckoning) {
+        qint64 elapsed = qBound<qint64>(0, currentTime - m_hitGridTime, m_coastTimeoutMs);
+        drift = (m_hitGridMaxSpeed * elapsed / 1000.0 + m_hitGridMaxCorrection) * m_scaleFactor;
+    }
+    if (drift <= 0.0) {
+        return m_hitGrid.findNearest(centeredPos, tolerance);
+    }
+
+    int nearest = -1;
+    double nearestDistanceSquared = tolerance * tolerance;
+    m_hitGrid.forEachInRadius(centeredPos, tolerance + drift, [&](int index, QPointF) {
+        QPointF delta = worldToScreen(m_drones[index].renderPosition) - centeredPos;
+        double distanceSquared = QPointF::dotProduct(delta, delta);
+        if (distanceSquared <= nearestDistanceSquared) {
+            nearestDistanceSquared = distanceSquared;
+            nearest = index;
+        }
+    });
+    return nearest;
 }
 
 QPointF RadarDisplay::worldToScreen(QPointF worldPos)
@@ -780,231 +1136,12 @@ void RadarDisplay::drawRadarGrid(QPainter& painter)
     painter.drawLine(QPointF(-screenRadius * 0.1, 0), QPointF(screenRadius * 0.1, 0));
     painter.drawLine(QPointF(0, -screenRadius * 0.1), QPointF(0, screenRadius * 0.1));
     
-    // 绘制扫描线和拖影效果
-    if (m_radarRunning) {
-        // 增强的拖影效果 - 更平滑的渐变
-        double trailSpan = 60.0; // 增加拖影跨度
-        int steps = 60; // 更多步骤，更平滑
-        
-        // 绘制多层拖影，创造更真实的雷达效果
-        for (int layer = 0; layer < 3; ++layer) {
-            double layerSpan = trailSpan * (1.0 - layer * 0.2); // 每层递减
-            int layerSteps = steps - layer * 10;
-            
-            for (int i = 0; i < layerSteps; ++i) {
-                double stepAngle = layerSpan / layerSteps;
-                double currentAngle = m_scanAngle - (i + 1) * stepAngle;
-                double nextAngle = m_scanAngle - i * stepAngle;
-                
-                // 多层衰减效果
-                double fadeRatio = 1.0 - (double(i) / layerSteps);
-                fadeRatio = fadeRatio * fadeRatio; // 二次衰减
-                int alpha = int((80 - layer * 20) * fadeRatio);
-                
-                if (alpha > 5) {
-                    double qtStartAngle = (90 - nextAngle) * 16;
-                    double qtSpanAngle = stepAngle * 16;
-                    
-                    // 不同层的颜色
-                    QColor layerColor;
-                    if (layer == 0) layerColor = QColor(0, 255, 0, alpha);      // 最亮绿色
-                    else if (layer == 1) layerColor = QColor(0, 200, 100, alpha); // 中等绿色
-                    else layerColor = QColor(0, 150, 150, alpha);                // 青绿色
-                    
-                    painter.setBrush(QBrush(layerColor));
-                    painter.setPen(Qt::NoPen);
-                    
-                    painter.drawPie(QRectF(-screenRadius, -screenRadius, 
-                                          2*screenRadius, 2*screenRadius), 
-                                   qtStartAngle, qtSpanAngle);
-                }
-            }
-        }
-        
-        double scanRad = qDegreesToRadians(m_scanAngle);
-        QPointF scanEnd(screenRadius * qSin(scanRad), -screenRadius * qCos(scanRad));
-        
-        // 扫描线发光效果
-        painter.setPen(QPen(QColor(0, 255, 0, 1), 8)); // 外发光
-        painter.drawLine(QPointF(0, 0), scanEnd);
-        painter.setPen(QPen(QColor(0, 255, 0, 11), 4)); // 主扫描线
-        painter.drawLine(QPointF(0, 0), scanEnd);
-        painter.setPen(QPen(QColor(255, 255, 255, 1), 2)); // 内核心
-        painter.drawLine(QPointF(0, 0), scanEnd);
-        
-        // 扫描线端点光点
-        painter.setBrush(QBrush(QColor(0, 255, 0, 1)));
-        painter.setPen(Qt::NoPen);
-        painter.drawEllipse(scanEnd, 4, 4);
-    }
-    
     // 绘制外边框
     painter.setPen(QPen(QColor(0, 255, 100, 200), 3));
     painter.setBrush(Qt::NoBrush);
     painter.drawEllipse(QPointF(0, 0), screenRadius, screenRadius);
 }
 
-void RadarDisplay::drawDrones(QPainter& painter)
-{
-    static int drawCount = 0;
-    if ((++drawCount % 50) == 0) { // 每50次绘制输出一次调试信息
-        qDebug() << "DRAW DRONES: Drawing" << m_drones.size() << "drones";
-        for (const DisplayDrone& drone : m_drones) {
-            qDebug() << "  Drone" << drone.id << "at world position" << drone.position
-                     << "screen position" << worldToScreen(drone.position);
-        }
-    }
-
-    for (const DisplayDrone& drone : m_drones) {
-        // 绘制轨迹
-        if (m_showTrails && !drone.trail.isEmpty()) {
-            drawDroneTrail(painter, drone);
-        }
-
-        // 绘制无人机
-        QPointF screenPos = worldToScreen(drone.position);
-
-        // 激光锁定高亮效果
-        if (drone.id == m_laserTargetId) {
-            // 绘制闪烁的锁定圆圈
-            qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-            double blinkPhase = (currentTime % 1000) / 1000.0; // 1秒周期
-            int alpha = (int)(128 + 127 * qSin(blinkPhase * 2 * M_PI)); // 闪烁透明度
-            
-            painter.setPen(QPen(QColor(255, 255, 255, alpha), 3)); // 白色闪烁圆圈
-            painter.setBrush(Qt::NoBrush);
-            painter.drawEllipse(screenPos, 15, 15); // 锁定圆圈
-            
-            // 绘制锁定十字线
-            painter.setPen(QPen(QColor(255, 255, 255, alpha), 2)); // 白色十字线
-            painter.drawLine(screenPos - QPointF(20, 0), screenPos + QPointF(20, 0));
-            painter.drawLine(screenPos - QPointF(0, 20), screenPos + QPointF(0, 20));
-        }
-
-        painter.setPen(QPen(drone.color, 2));
-        painter.setBrush(drone.color);
-
-        // 绘制无人机图标 - 更专业的显示
-        QPolygonF triangle;
-        double size = 10; // 增大箭头尺寸
-        triangle << QPointF(0, -size) << QPointF(-size/2, size/2) << QPointF(size/2, size/2);
-
-        painter.save();
-        painter.translate(screenPos);
-
-        // 根据方向旋转三角形
-        if (drone.useNewTrajectory) {
-            // 新轨迹系统：使用实际运动方向
-            double angle = drone.currentDirection;
-            painter.rotate(qRadiansToDegrees(angle) + 90); // +90度因为三角形默认向上
-        } else {
-            // 旧系统：根据速度方向
-            if (drone.velocity.manhattanLength() > 0) {
-                double angle = qAtan2(drone.velocity.x(), -drone.velocity.y());
-                painter.rotate(qRadiansToDegrees(angle));
-            }
-        }
-
-        // 绘制无人机发光效果
-        painter.setPen(QPen(QColor(drone.color.red(), drone.color.green(), drone.color.blue(), 100), 6));
-        painter.setBrush(Qt::NoBrush);
-        painter.drawPolygon(triangle);
-        
-        // 绘制无人机主体
-        painter.setPen(QPen(drone.color, 2));
-        painter.setBrush(QBrush(drone.color));
-        painter.drawPolygon(triangle);
-        
-        // 绘制内部高光
-        painter.setPen(QPen(QColor(255, 255, 255, 150), 1));
-        painter.setBrush(Qt::NoBrush);
-        painter.drawPolygon(triangle);
-
-        painter.restore();
-
-        // 绘制详细信息（包含ID，去掉白色ID）
-        if (m_showInfo) {
-            drawDroneInfo(painter, drone);
-        }
-    }
-}
-
-void RadarDisplay::drawDroneInfo(QPainter& painter, const DisplayDrone& drone)
-{
-    QPointF screenPos = worldToScreen(drone.position);
-    
-    // 分别显示ID和速度，两行显示
-    double speed;
-    if (drone.useNewTrajectory && drone.currentSpeed > 0) {
-        // 新轨迹系统：使用实际物理速度
-        speed = drone.currentSpeed;
-    } else {
-        // 旧系统：计算速度向量大小
-        speed = qSqrt(drone.velocity.x() * drone.velocity.x() + drone.velocity.y() * drone.velocity.y());
-    }
-    
-    QString idText = QString("%1").arg(drone.id);  // 去掉"ID:"
-    QString speedText = QString("%1m/s").arg(speed, 0, 'f', 1);
-    // 直接使用 drone.distance，这是从 RadarSimulator 正确计算的距离
-    QString distanceText = QString("%1m").arg(drone.distance, 0, 'f', 0);
-
-    QPointF textPos = screenPos + QPointF(15, 15);
-    
-    // 绘制ID号 - 白色加大加粗
-    painter.setPen(Qt::white);
-    QFont idFont = painter.font();
-    idFont.setPointSize(12);  // 较大字体
-    idFont.setBold(true);     // 加粗
-    painter.setFont(idFont);
-    painter.drawText(textPos, idText);
-    
-    // 绘制速度和距离 - 与三角形同色，字体更大
-    painter.setPen(drone.color);  // 使用与三角形相同的颜色
-    QFont infoFont = painter.font();
-    infoFont.setPointSize(10);   // 增大字体
-    infoFont.setBold(false);     // 不加粗
-    painter.setFont(infoFont);
-    painter.drawText(textPos + QPointF(0, 16), speedText);     // 速度在第二行
-    painter.drawText(textPos + QPointF(0, 28), distanceText);  // 距离在第三行
-}
-
-void RadarDisplay::drawDroneTrail(QPainter& painter, const DisplayDrone& drone)
-{
-    if (drone.trail.isEmpty()) return;
-
-    // 绘制带渐变透明度的轨迹，越老的轨迹越透明
-    for (int i = 1; i < drone.trail.size(); ++i) {
-        double alpha = double(i) / drone.trail.size(); // 0到1的透明度
-        QColor trailColor = drone.color;
-        trailColor.setAlpha(int(255 * alpha * 0.8)); // 最大透明度为80%
-
-        // 使用更平滑的线条样式
-        painter.setPen(QPen(trailColor, 3, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-
-        QPointF p1 = worldToScreen(drone.trail[i-1]);
-        QPointF p2 = worldToScreen(drone.trail[i]);
-        painter.drawLine(p1, p2);
-        
-        // 添加轨迹点标记
-        if (i % 3 == 0) { // 每3个点画一个小圆点
-            painter.setBrush(QBrush(trailColor));
-            painter.setPen(Qt::NoPen);
-            painter.drawEllipse(p1, 2, 2);
-        }
-    }
-
-    // 连接最后一个轨迹点到当前位置（最亮）
-    if (!drone.trail.isEmpty()) {
-        QColor trailColor = drone.color;
-        trailColor.setAlpha(220); // 更亮的连接线
-        painter.setPen(QPen(trailColor, 4, Qt::DotLine)); // 增加线条粗细
-
-        QPointF lastTrail = worldToScreen(drone.trail.last());
-        QPointF currentPos = worldToScreen(drone.position);
-        painter.drawLine(lastTrail, currentPos);
-    }
-}
-
 QColor RadarDisplay::getDroneColor(int droneId)
 {
     return m_droneColors[droneId % m_droneColors.size()];
@@ -1028,105 +1165,6 @@ QColor RadarDisplay::getThreatBasedColor(double threatScore)
     }
 }
 
-void RadarDisplay::drawStrikeHighlight(QPainter& painter)
-{
-    // 设置画笔和笔刷为打击高亮效果
-    QPen pen(QColor(255, 0, 0, 200), 4); // 红色，半透明，粗线条
-    pen.setStyle(Qt::DashLine);
-    painter.setPen(pen);
-
-    QBrush brush(QColor(255, 0, 0, 50)); // 红色填充，更透明
-    painter.setBrush(brush);
-
-    // 转换打击中心到屏幕坐标
-    QPointF centerScreen = worldToScreen(m_strikeCenter);
-
-    // 将世界坐标的半径转换为屏幕坐标的半径
-    double radiusScreen = m_strikeRadius * m_scaleFactor;
-
-    // 绘制打击区域圆圈
-    painter.drawEllipse(centerScreen, radiusScreen, radiusScreen);
-
-    // 在中心绘制一个小十字标记
-    painter.setPen(QPen(QColor(255, 255, 0, 255), 2)); // 黄色十字
-    double crossSize = 10;
-    painter.drawLine(centerScreen.x() - crossSize, centerScreen.y(),
-                    centerScreen.x() + crossSize, centerScreen.y());
-    painter.drawLine(centerScreen.x(), centerScreen.y() - crossSize,
-                    centerScreen.x(), centerScreen.y() + crossSize);
-}
-
-// 新增：绘制动画打击效果
-void RadarDisplay::drawStrikeEffects(QPainter& painter)
-{
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-
-    // 绘制所有活跃的打击效果
-    for (auto it = m_strikeEffects.begin(); it != m_strikeEffects.end(); ) {
-        StrikeEffect& effect = *it;
-        qint64 elapsed = currentTime - effect.startTime;
-
-        if (elapsed >= effect.duration) {
-            // 动画结束，移除效果
-            it = m_strikeEffects.erase(it);
-            continue;
-        }
-
-        // 计算动画进度 (0.0 到 1.0)
-        double progress = static_cast<double>(elapsed) / effect.duration;
-
-        // 创建脉冲效果
-        effect.pulsePhase += 0.3; // 恢复原来的脉冲速度
-        double pulseScale = 1.0 + 0.5 * qSin(effect.pulsePhase); // 恢复原来的脉冲幅度
-
-        // 随时间增长的外圈
-        double outerRadius = effect.radius * (1.0 + progress * 2.0) * pulseScale;
-        double innerRadius = effect.radius * pulseScale;
-
-        // 渐变透明度
-        int alpha = static_cast<int>(255 * (1.0 - progress));
-
-        // 绘制外圈（冲击波效果）
-        QPen outerPen(QColor(255, 100, 0, alpha / 2), 4); // 更粗的线条和更高的透明度
-        painter.setPen(outerPen);
-        painter.setBrush(Qt::NoBrush);
-
-        QPointF centerScreen = worldToScreen(effect.center);
-        double outerRadiusScreen = outerRadius * m_scaleFactor;
-        painter.drawEllipse(centerScreen, outerRadiusScreen, outerRadiusScreen);
-
-        // 绘制内圈（核心爆炸效果）
-        QPen innerPen(QColor(255, 200, 0, alpha), 3); // 更粗的线条
-        painter.setPen(innerPen);
-        QBrush innerBrush(QColor(255, 150, 0, alpha / 3)); // 更明显的填充
-        painter.setBrush(innerBrush);
-
-        double innerRadiusScreen = innerRadius * m_scaleFactor;
-        painter.drawEllipse(centerScreen, innerRadiusScreen, innerRadiusScreen);
-
-        // 绘制火花效果
-        if (progress < 0.5) {
-            painter.setPen(QPen(QColor(255, 255, 100, alpha), 1));
-            for (int i = 0; i < 8; ++i) {
-                double angle = i * M_PI / 4.0 + effect.pulsePhase * 0.1;
-                double sparkLength = innerRadiusScreen * (1.5 + 0.5 * qSin(effect.pulsePhase + i));
-                QPointF sparkEnd = centerScreen + QPointF(
-                    qCos(angle) * sparkLength,
-                    qSin(angle) * sparkLength
-                );
-                painter.drawLine(centerScreen, sparkEnd);
-            }
-        }
-
-        ++it;
-    }
-
-    // 如果有活跃效果，继续更新
-    if (!m_strikeEffects.isEmpty()) {
-        update();
-    }
-}
-
 // 新增：绘制打击模式鼠标光标
 void RadarDisplay::drawStrikeCursor(QPainter& painter)
 {
@@ -1208,14 +1246,37 @@ void RadarDisplay::drawHoverEffect(QPainter& painter)
         QPointF end = start + direction * indicatorSize;
         painter.drawLine(start, end);
     }
-
-    // 继续更新动画
-    update();
 }
 
 // 新增：控制雷达扫描线
 void RadarDisplay::setRadarRunning(bool running)
 {
     m_radarRunning = running;
+    m_frameScheduler->setAnimationActive(SweepAnimation, running);
+    m_frameScheduler->invalidate();
     qDebug() << "Radar display running state set to:" << running;
 }
+
+// 与服务器旋转波束同步扫描线角度（服务器角度为弧度，0为北，顺时针）
+void RadarDisplay::syncBeamAngle(double beamStart, double beamWidth, int sectorIndex, int sectorCount)
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    double widthDegrees = qRadiansToDegrees(beamWidth);
+
+    // 根据相邻两帧的时间间隔估计波束角速度和转一圈的时间
+    if (m_lastBeamSyncTime > 0) {
+        qint64 interval = now - m_lastBeamSyncTime;
+        if (interval > 0 && interval < 2000) {
+            double rate = widthDegrees / interval;
+            m_beamRateDegPerMs = (m_beamRateDegPerMs > 0) ? m_beamRateDegPerMs * 0.8 + rate * 0.2 : rate;
+            m_beamRotationMs = qint64(interval) * sectorCount;
+        }
+    }
+
+    // 扫描线对齐到刚扫完扇区的终止边（服务器波束前沿），随后向下一个扇区外推
+    m_beamSyncAngle = std::fmod(qRadiansToDegrees(beamStart + beamWidth), 360.0);
+    m_beamWidthDegrees = widthDegrees;
+    m_lastBeamSyncTime = now;
+    m_scanAngle = m_beamSyncAngle;
+    Q_UNUSED(sectorIndex)
+}
@@ -0,0 +1,292 @@
+#include "RadarNetwork.h"
+#include "RadarWorker.h"
+#include <QDebug>
+#include <QDateTime>
+
+RadarNetworkWorker::RadarNetworkWorker(DroneManager* droneManager, QObject *parent)
+    : QObject(parent)
+    , m_droneManager(droneManager)
+    , m_scanTimer(nullptr)
+    , m_udpSocket(nullptr)
+    , m_scanInterval(1000)
+    , m_indexedSequence(0)
+    , m_indexValid(false)
+{
+    // 定时器和套接字在initialize()中创建，保证它们属于工作线程
+}
+
+RadarNetworkWorker::~RadarNetworkWorker()
+{
+    shutdown();
+}
+
+void RadarNetworkWorker::initialize()
+{
+    if (m_scanTimer) {
+        return;
+    }
+
+    m_scanTimer = new QTimer(this);
+    m_scanTimer->setTimerType(Qt::PreciseTimer);
+    m_udpSocket = new QUdpSocket(this);
+
+    connect(m_scanTimer, &QTimer::timeout, this, &RadarNetworkWorker::performNetworkScan);
+}
+
+void RadarNetworkWorker::shutdown()
+{
+    if (m_scanTimer) {
+        m_scanTimer->stop();
+    }
+    if (m_udpSocket) {
+        m_udpSocket->close();
+    }
+}
+
+void RadarNetworkWorker::startScanning(int intervalMs)
+{
+    initialize();
+    m_scanInterval = intervalMs;
+    m_scanTimer->start(m_scanInterval);
+    qDebug() << "Radar network scanning" << m_sites.size() << "sites with interval:" << m_scanInterval << "ms";
+}
+
+void RadarNetworkWorker::stopScanning()
+{
+    if (m_scanTimer && m_scanTimer->isActive()) {
+        m_scanTimer->stop();
+    }
+}
+
+void RadarNetworkWorker::setScanInterval(int intervalMs)
+{
+    m_scanInterval = intervalMs;
+    if (m_scanTimer && m_scanTimer->isActive()) {
+        m_scanTimer->start(m_scanInterval);
+    }
+}
+
+void RadarNetworkWorker::setSites(const QVector<RadarSite>& sites)
+{
+    m_sites = sites;
+
+    // 网格单元取最小站点半径的一半：单个站点查询约覆盖5x5个单元
+    double minRadius = 0.0;
+    for (const RadarSite& site : m_sites) {
+        if (minRadius <= 0.0 || site.radius < minRadius) {
+            minRadius = site.radius;
+        }
+    }
+    m_droneGrid.setCellSize(qMax(50.0, minRadius / 2.0));
+    m_indexValid = false;
+}
+
+void RadarNetworkWorker::rebuildDroneIndex(const DroneSnapshot& snapshot)
+{
+    m_droneGrid.clear();
+    for (int i = 0; i < snapshot.drones.size(); ++i) {
+        m_droneGrid.insert(i, snapshot.drones[i].position);
+    }
+    m_indexedSequence = snapshot.sequence;
+    m_indexValid = true;
+}
+
+void RadarNetworkWorker::performNetworkScan()
+{
+    if (m_sites.isEmpty()) {
+        return;
+    }
+
+    DroneSnapshotPtr snapshot = m_droneManager->getSnapshot();
+    if (!snapshot) {
+        return;
+    }
+
+    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+    int totalDetections = 0;
+
+    for (const RadarSite& site : m_sites) {
+        QList<RadarDetection> detections = scanSite(*snapshot, site, currentTime);
+
+        if (!detections.isEmpty() && !site.clients.isEmpty()) {
+            sendDataToClients(site, RadarWorker::serializeDetections(detections));
+        }
+
+        totalDetections += detections.size();
+        emit siteScanCompleted(site.siteId, detections);
+    }
+
+    emit networkScanCompleted(m_sites.size(), totalDetections);
+}
+
+QList<RadarDetection> RadarNetworkWorker::scanSite(const DroneSnapshot& snapshot, const RadarSite& site,
+                                                  qint64 detectionTime)
+{
+    // 同一快照只建立一次索引，所有站点共享
+    if (!m_indexValid || m_indexedSequence != snapshot.sequence) {
+        rebuildDroneIndex(snapshot);
+    }
+
+    QList<RadarDetection> detections;
+    RadarDetection detection;
+    m_droneGrid.forEachInRadius(site.center, site.radius, [&](int index, QPointF) {
+        if (RadarWorker::detectState(snapshot.drones[index], site.center, site.radius, detectionTime, detection)) {
+            detections.append(detection);
+        }
+    });
+    return detections;
+}
+
+void RadarNetworkWorker::sendDataToClients(const RadarSite& site, const QByteArray& data)
+{
+    for (const QPair<QHostAddress, quint16>& client : site.clients) {
+        qint64 bytesWritten = m_udpSocket->writeDatagram(data, client.first, client.second);
+        if (bytesWritten == -1) {
+            qWarning() << "Radar site" << site.siteId << "failed to send UDP data to"
+                       << client.first.toString() << ":" << client.second << m_udpSocket->errorString();
+        }
+    }
+}
+
+RadarNetwork::RadarNetwork(DroneManager* droneManager, QObject *parent)
+    : QObject(parent)
+    , m_nextSiteId(1)
+    , m_scanInterval(1000)
+    , m_running(false)
+    , m_fusionEnabled(false)
+{
+    qRegisterMetaType<RadarDetection>("RadarDetection");
+    qRegisterMetaType<QList<RadarDetection>>("QList<RadarDetection>");
+
+    m_workerThread = new QThread(this);
+    m_workerThread->setObjectName("RadarNetworkThread");
+    m_worker = new RadarNetworkWorker(droneManager);
+    m_worker->moveToThread(m_workerThread);
+
+    connect(m_workerThread, &QThread::started, m_worker, &RadarNetworkWorker::initialize);
+    connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &RadarNetworkWorker::siteScanCompleted, this, &RadarNetwork::siteScanCompleted);
+    connect(m_worker, &RadarNetworkWorker::networkScanCompleted, this, &RadarNetwork::networkScanCompleted);
+
+    // 两者同属工作线程，站点检测以直接连接提交给融合引擎
+    m_fusionEngine = new FusionEngine();
+    m_fusionEngine->moveToThread(m_workerThread);
+    connect(m_workerThread, &QThread::finished, m_fusionEngine, &QObject::deleteLater);
+    connect(m_worker, &RadarNetworkWorker::siteScanCompleted, m_fusionEngine, &FusionEngine::submitDetections);
+    connect(m_fusionEngine, &FusionEngine::fusedTracksUpdated, this, &RadarNetwork::fusedTracksUpdated);
+
+    m_workerThread->start(QThread::HighPriority);
+}
+
+RadarNetwork::~RadarNetwork()
+{
+    QMetaObject::invokeMethod(m_worker, &RadarNetworkWorker::shutdown, Qt::BlockingQueuedConnection);
+    QMetaObject::invokeMethod(m_fusionEngine, &FusionEngine::stop, Qt::BlockingQueuedConnection);
+    m_workerThread->quit();
+    m_workerThread->wait();
+}
+
+int RadarNetwork::addSite(QPointF center, double radius, const QString& name)
+{
+    RadarSite site;
+    site.siteId = m_nextSiteId++;
+    site.name = name.isEmpty() ? QString("Radar-%1").arg(site.siteId) : name;
+    site.center = center;
+    site.radius = radius;
+    m_sites.append(site);
+
+    syncSites();
+    qDebug() << "Radar site added:" << site.siteId << site.name << "center:" << center << "radius:" << radius;
+    return site.siteId;
+}
+
+bool RadarNetwork::removeSite(int siteId)
+{
+    int index = findSite(siteId);
+    if (index < 0) {
+        return false;
+    }
+
+    m_sites.remove(index);
+    syncSites();
+    QMetaObject::invokeMethod(m_fusionEngine, [engine = m_fusionEngine, siteId]() {
+        engine->removeSource(siteId);
+    }, Qt::QueuedConnection);
+    return true;
+}
+
+void RadarNetwork::removeAllSites()
+{
+    m_sites.clear();
+    syncSites();
+    QMetaObject::invokeMethod(m_fusionEngine, &FusionEngine::reset, Qt::QueuedConnection);
+}
+
+bool RadarNetwork::addSiteClient(int siteId, const QHostAddress& address, quint16 port)
+{
+    int index = findSite(siteId);
+    if (index < 0) {
+        qWarning() << "Unknown radar site:" << siteId;
+        return false;
+    }
+
+    QPair<QHostAddress, quint16> client(address, port);
+    if (!m_sites[index].clients.contains(client)) {
+        m_sites[index].clients.append(client);
+        syncSites();
+    }
+    return true;
+}
+
+void RadarNetwork::startNetwork(int intervalMs)
+{
+    m_scanInterval = intervalMs;
+    m_running = true;
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, intervalMs]() {
+        worker->startScanning(intervalMs);
+    }, Qt::QueuedConnection);
+}
+
+void RadarNetwork::stopNetwork()
+{
+    m_running = false;
+    QMetaObject::invokeMethod(m_worker, &RadarNetworkWorker::stopScanning, Qt::QueuedConnection);
+}
+
+void RadarNetwork::setScanInterval(int intervalMs)
+{
+    m_scanInterval = intervalMs;
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, intervalMs]() {
+        worker->setScanInterval(intervalMs);
+    }, Qt::QueuedConnection);
+}
+
+void RadarNetwork::setFusionEnabled(bool enabled, int cycleMs)
+{
+    m_fusionEnabled = enabled;
+    if (enabled) {
+        QMetaObject::invokeMethod(m_fusionEngine, [engine = m_fusionEngine, cycleMs]() {
+            engine->start(cycleMs);
+        }, Qt::QueuedConnection);
+    } else {
+        QMetaObject::invokeMethod(m_fusionEngine, &FusionEngine::stop, Qt::QueuedConnection);
+    }
+}
+
+void RadarNetwork::syncSites()
+{
+    QVector<RadarSite> sites = m_sites;
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, sites]() {
+        worker->setSites(sites);
+    }, Qt::QueuedConnection);
+}
+
+int RadarNetwork::findSite(int siteId) const
+{
+    for (int i = 0; i < m_sites.size(); ++i) {
+        if (m_sites[i].siteId == siteId) {
+            return i;
+        }
+    }
+    return -1;
+}
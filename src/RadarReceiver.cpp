@@ -0,0 +1,257 @@
+#include "RadarReceiver.h"
+#include "MetricsRegistry.h"
+#include <QDebug>
+#include <QtEndian>
+#include <cstring>
+
+RadarFrameQueue::RadarFrameQueue(int capacity, int reservedDetections)
+    : m_frames(qMax(2, capacity))
+    , m_head(0)
+    , m_tail(0)
+    , m_overflowBack(0)
+    , m_overflowFront(2)
+    , m_overflowMiddle(1)
+{
+    for (RadarFrame& frame : m_frames) {
+        frame.detections.reserve(reservedDetections);
+    }
+    for (RadarFrame& frame : m_overflow) {
+        frame.detections.reserve(reservedDetections);
+    }
+}
+
+bool RadarFrameQueue::commitOverwrite()
+{
+    int previous = m_overflowMiddle.exchange(m_overflowBack | OverflowFresh, std::memory_order_acq_rel);
+    m_overflowBack = previous & ~OverflowFresh;
+    return (previous & OverflowFresh) != 0;
+}
+
+const RadarFrame* RadarFrameQueue::takeOverflow()
+{
+    if (!(m_overflowMiddle.load(std::memory_order_relaxed) & OverflowFresh)) {
+        return nullptr;
+    }
+    int previous = m_overflowMiddle.exchange(m_overflowFront, std::memory_order_acq_rel);
+    m_overflowFront = previous & ~OverflowFresh;
+    return &m_overflow[m_overflowFront];
+}
+
+RadarFrame* RadarFrameQueue::beginWrite()
+{
+    quint64 head = m_head.load(std::memory_order_relaxed);
+    quint64 tail = m_tail.load(std::memory_order_acquire);
+    if (head - tail >= quint64(m_frames.size())) {
+        return nullptr; // 队列已满
+    }
+    return &m_frames[int(head % m_frames.size())];
+}
+
+void RadarFrameQueue::commitWrite()
+{
+    m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+int RadarFrameQueue::available() const
+{
+    return int(m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_relaxed));
+}
+
+const RadarFrame& RadarFrameQueue::peek(int offset) const
+{
+    quint64 tail = m_tail.load(std::memory_order_relaxed);
+    return m_frames[int((tail + offset) % m_frames.size())];
+}
+
+void RadarFrameQueue::consume(int count)
+{
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+// 大端读取游标，越界时置失败标志
+namespace {
+struct StreamCursor {
+    const uchar* data;
+    int size;
+    int pos;
+    bool ok;
+
+    bool require(int bytes)
+    {
+        if (!ok || pos + bytes > size) {
+            ok = false;
+            return false;
+        }
+        return true;
+    }
+    quint32 readUInt32()
+    {
+        if (!require(4)) return 0;
+        quint32 value = qFromBigEndian<quint32>(data + pos);
+        pos += 4;
+        return value;
+    }
+    qint32 readInt32() { return qint32(readUInt32()); }
+    qint64 readInt64()
+    {
+        if (!require(8)) return 0;
+        qint64 value = qFromBigEndian<qint64>(data + pos);
+        pos += 8;
+        return value;
+    }
+    double readDouble()
+    {
+        // QDataStream默认以双精度写入浮点数
+        quint64 bits = quint64(readInt64());
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    bool readBool()
+    {
+        if (!require(1)) return false;
+        return data[pos++] != 0;
+    }
+};
+}
+
+bool RadarReceiver::decodeFrame(const char* data, int size, RadarFrame& frame)
+{
+    // 单个检测记录的字节数：id + 位置 + 速度 + 时间 + 距离 + 方位 + 两个枚举 + 方向 + 速度 + 标志
+    static const int detectionRecordSize = 4 + 16 + 16 + 8 + 8 + 8 + 4 + 4 + 8 + 8 + 1;
+
+    StreamCursor cursor = { reinterpret_cast<const uchar*>(data), size, 0, true };
+
+    if (cursor.readUInt32() != 0x52444152) { // "RDAR"
+        return false;
+    }
+    frame.version = cursor.readUInt32();
+    if (frame.version != 1 && frame.version != 2) {
+        return false;
+    }
+    frame.timestamp = cursor.readInt64();
+
+    // 版本2为旋转波束的扇区帧，附带波束角度
+    if (frame.version == 2) {
+        frame.beamStart = cursor.readDouble();
+        frame.beamWidth = cursor.readDouble();
+        frame.sectorIndex = int(cursor.readUInt32());
+        frame.sectorCount = int(cursor.readUInt32());
+    }
+
+    quint32 count = cursor.readUInt32();
+    if (!cursor.ok || qint64(count) * detectionRecordSize > qint64(size - cursor.pos)) {
+        return false;
+    }
+
+    frame.detections.resize(int(count));
+    for (RadarDetection& detection : frame.detections) {
+        detection.droneId = cursor.readInt32();
+        double x = cursor.readDouble();
+        double y = cursor.readDouble();
+        detection.position = QPointF(x, y);
+        double vx = cursor.readDouble();
+        double vy = cursor.readDouble();
+        detection.velocity = QPointF(vx, vy);
+        detection.detectionTime = cursor.readInt64();
+        detection.distance = cursor.readDouble();
+        detection.azimuth = cursor.readDouble();
+        detection.trajectoryType = static_cast<TrajectoryType>(cursor.readUInt32());
+        detection.speedType = static_cast<SpeedType>(cursor.readUInt32());
+        detection.currentDirection = cursor.readDouble();
+        detection.currentSpeed = cursor.readDouble();
+        detection.useNewTrajectory = cursor.readBool();
+    }
+
+    return cursor.ok;
+}
+
+RadarReceiver::RadarReceiver(QObject *parent)
+    : QObject(parent)
+    , m_udpSocket(nullptr)
+    , m_queue(16, 256)
+    , m_notifyPending(false)
+    , m_receivedFrames(0)
+    , m_droppedFrames(0)
+    , m_malformedFrames(0)
+{
+    // 套接字在bindSocket()中创建，保证它属于接收线程
+}
+
+RadarReceiver::~RadarReceiver()
+{
+    closeSocket();
+}
+
+bool RadarReceiver::bindSocket(const QHostAddress& address, quint16 port)
+{
+    if (!m_udpSocket) {
+        m_udpSocket = new QUdpSocket(this);
+        connect(m_udpSocket, &QUdpSocket::readyRead, this, &RadarReceiver::readPendingDatagrams);
+    }
+
+    if (m_udpSocket->state() == QAbstractSocket::BoundState) {
+        return true;
+    }
+
+    if (!m_udpSocket->bind(address, port)) {
+        qDebug() << "Failed to bind UDP socket to port" << port << ":" << m_udpSocket->errorString();
+        return false;
+    }
+    return true;
+}
+
+void RadarReceiver::closeSocket()
+{
+    if (m_udpSocket) {
+        m_udpSocket->close();
+    }
+}
+
+void RadarReceiver::readPendingDatagrams()
+{
+    static MetricGauge* queueDepth = MetricsRegistry::instance().gauge(
+        "radar_receiver_queue_depth", "Decoded radar frames waiting for the display");
+    static MetricCounter* droppedFrames = MetricsRegistry::instance().counter(
+        "radar_receiver_dropped_frames_total", "Overflow radar frames overwritten by a newer frame before display");
+
+    bool produced = false;
+
+    while (m_udpSocket->hasPendingDatagrams()) {
+        qint64 pendingSize = m_udpSocket->pendingDatagramSize();
+        if (m_datagramBuffer.size() < pendingSize) {
+            m_datagramBuffer.resize(int(pendingSize));
+        }
+        qint64 bytesRead = m_udpSocket->readDatagram(m_datagramBuffer.data(), m_datagramBuffer.size());
+        if (bytesRead <= 0) {
+            continue;
+        }
+        m_receivedFrames.fetch_add(1, std::memory_order_relaxed);
+
+        // 界面严重滞后、队列已满时写入溢出槽：保留最新帧，被它覆盖的上一个溢出帧计为丢弃
+        RadarFrame* frame = m_queue.beginWrite();
+        const bool overflow = (frame == nullptr);
+        if (overflow) {
+            frame = m_queue.beginOverwrite();
+        }
+
+        if (!decodeFrame(m_datagramBuffer.constData(), int(bytesRead), *frame)) {
+            m_malformedFrames.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        if (!overflow) {
+            m_queue.commitWrite();
+        } else if (m_queue.commitOverwrite()) {
+            m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            droppedFrames->add();
+        }
+        produced = true;
+    }
+    queueDepth->set(m_queue.available());
+
+    // 合并通知：上一次通知尚未被处理时不再重复投递事件
+    if (produced && !m_notifyPending.exchange(true, std::memory_order_acq_rel)) {
+        emit framesAvailable();
+    }
+}
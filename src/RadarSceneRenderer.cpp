@@ -0,0 +1,482 @@
+#include "RadarSceneRenderer.h"
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QFont>
+#include <QConicalGradient>
+#include <QtMath>
+
+void RadarSceneRenderer::render(QPainter& painter, const RadarScene& scene)
+{
+    m_scaleFactor = scene.scaleFactor;
+
+    // 绘制扫描线
+    drawScanSweep(painter, scene);
+
+    // 绘制无人机：目标过多时改为密度热力图，不再画单个图标和标签
+    if (scene.heatmapMode) {
+        drawHeatmap(painter, scene);
+        drawLaserLock(painter, scene);
+    } else {
+        drawDrones(painter, scene);
+    }
+
+    // 绘制打击高亮
+    if (scene.showStrikeHighlight) {
+        drawStrikeHighlight(painter, scene);
+    }
+
+    // 绘制动画打击效果
+    drawStrikeEffects(painter, scene);
+}
+
+void RadarSceneRenderer::ensureSweepTexture(double screenRadius, qreal pixelRatio)
+{
+    const int pixelSize = qCeil(2 * screenRadius * pixelRatio);
+    if (!m_sweepTexture.isNull() && m_sweepTexture.width() == pixelSize
+        && qFuzzyCompare(m_sweepTexture.devicePixelRatio(), pixelRatio)) {
+        return;
+    }
+
+    // 拖影原为三层逐片drawPie叠加：按相同的二次衰减和叠加顺序算出各角度的合成颜色，作为锥形渐变的色标
+    const double trailSpan = 60.0;
+    const QColor layerColors[3] = { QColor(0, 255, 0), QColor(0, 200, 100), QColor(0, 150, 150) };
+    const int stopCount = 48;
+
+    QConicalGradient gradient(QPointF(0, 0), 90); // 从正北开始，色标沿逆时针即扫描线后方排列
+    for (int k = 0; k <= stopCount; ++k) {
+        double behind = trailSpan * k / stopCount; // 落后扫描线的角度
+        double r = 0.0, g = 0.0, b = 0.0, a = 0.0;  // 预乘颜色
+        for (int layer = 0; layer < 3; ++layer) {
+            double layerSpan = trailSpan * (1.0 - layer * 0.2);
+            if (behind >= layerSpan) {
+                continue;
+            }
+            double fadeRatio = 1.0 - behind / layerSpan;
+            fadeRatio = fadeRatio * fadeRatio; // 二次衰减
+            double alpha = (80 - layer * 20) * fadeRatio / 255.0;
+            if (alpha * 255.0 <= 5) {
+                continue;
+            }
+            // 后绘制的层盖在上面（source-over）
+            r = layerColors[layer].redF() * alpha + r * (1.0 - alpha);
+            g = layerColors[layer].greenF() * alpha + g * (1.0 - alpha);
+            b = layerColors[layer].blueF() * alpha + b * (1.0 - alpha);
+            a = alpha + a * (1.0 - alpha);
+        }
+        QColor color = (a > 0.0) ? QColor::fromRgbF(r / a, g / a, b / a, a) : QColor(0, 0, 0, 0);
+        gradient.setColorAt(trailSpan * k / stopCount / 360.0, color);
+    }
+    gradient.setColorAt(1.0, QColor(0, 0, 0, 0));
+
+    // 使用QImage而不是QPixmap，纹理可在渲染线程中生成和绘制
+    m_sweepTexture = QImage(pixelSize, pixelSize, QImage::Format_ARGB32_Premultiplied);
+    m_sweepTexture.setDevicePixelRatio(pixelRatio);
+    m_sweepTexture.fill(Qt::transparent);
+
+    QPainter texturePainter(&m_sweepTexture);
+    texturePainter.setRenderHint(QPainter::Antialiasing);
+    texturePainter.translate(screenRadius, screenRadius);
+    texturePainter.setPen(Qt::NoPen);
+    texturePainter.setBrush(gradient);
+    texturePainter.drawEllipse(QPointF(0, 0), screenRadius, screenRadius);
+    texturePainter.end();
+}
+
+void RadarSceneRenderer::drawScanSweep(QPainter& painter, const RadarScene& scene)
+{
+    double screenRadius = scene.radarRadius * m_scaleFactor;
+
+    // 绘制扫描线和拖影效果
+    if (scene.radarRunning && screenRadius > 0) {
+        // 拖影纹理只在尺寸变化时生成，每帧旋转到当前扫描角后贴图
+        ensureSweepTexture(screenRadius, scene.devicePixelRatio);
+
+        painter.save();
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.rotate(scene.scanAngle); // 0为正北，顺时针
+        painter.drawImage(QRectF(-screenRadius, -screenRadius, 2*screenRadius, 2*screenRadius), m_sweepTexture);
+        painter.restore();
+
+        double scanRad = qDegreesToRadians(scene.scanAngle);
+        QPointF scanEnd(screenRadius * qSin(scanRad), -screenRadius * qCos(scanRad));
+
+        // 扫描线发光效果
+        painter.setPen(QPen(QColor(0, 255, 0, 1), 8)); // 外发光
+        painter.drawLine(QPointF(0, 0), scanEnd);
+        painter.setPen(QPen(QColor(0, 255, 0, 11), 4)); // 主扫描线
+        painter.drawLine(QPointF(0, 0), scanEnd);
+        painter.setPen(QPen(QColor(255, 255, 255, 1), 2)); // 内核心
+        painter.drawLine(QPointF(0, 0), scanEnd);
+
+        // 扫描线端点光点
+        painter.setBrush(QBrush(QColor(0, 255, 0, 1)));
+        painter.setPen(Qt::NoPen);
+        painter.drawEllipse(scanEnd, 4, 4);
+    }
+}
+
+void RadarSceneRenderer::drawDrones(QPainter& painter, const RadarScene& scene)
+{
+    // 绘制轨迹
+    if (scene.showTrails) {
+        drawTrails(painter, scene);
+    }
+
+    // 激光锁定高亮效果（只有一个目标，单独绘制）
+    drawLaserLock(painter, scene);
+
+    // 目标数量超过阈值时切换为点精灵，只画彩色圆点
+    if (scene.spriteMode) {
+        drawDroneSprites(painter, scene);
+        return;
+    }
+
+    // 按颜色和外推状态分组，把三角形直接变换到屏幕坐标后合并为一条路径
+    for (auto it = m_droneBodyBatches.begin(); it != m_droneBodyBatches.end(); ++it) {
+        it.value().clear();
+    }
+
+    const double size = 10; // 增大箭头尺寸
+    const QPointF vertices[3] = { QPointF(0, -size), QPointF(-size/2, size/2), QPointF(size/2, size/2) };
+
+    for (const RenderDrone& drone : scene.drones) {
+        const double c = qCos(drone.angle);
+        const double s = qSin(drone.angle);
+        const QPointF screenPos = toScreen(drone.position);
+
+        QPolygonF triangle;
+        triangle.reserve(4);
+        for (const QPointF& v : vertices) {
+            triangle << screenPos + QPointF(v.x() * c - v.y() * s, v.x() * s + v.y() * c);
+        }
+        triangle << triangle.first();
+
+        quint64 key = (quint64(drone.color) << 1) | (drone.coasting ? 1 : 0);
+        QPainterPath& path = m_droneBodyBatches[key];
+        path.setFillRule(Qt::WindingFill);
+        path.addPolygon(triangle);
+    }
+
+    for (auto it = m_droneBodyBatches.constBegin(); it != m_droneBodyBatches.constEnd(); ++it) {
+        const QPainterPath& path = it.value();
+        if (path.isEmpty()) {
+            continue;
+        }
+        QColor color = QColor::fromRgb(QRgb(it.key() >> 1));
+        painter.setOpacity((it.key() & 1) ? 0.5 : 1.0); // 外推中的目标半透明显示
+
+        // 绘制无人机发光效果
+        painter.setPen(QPen(QColor(color.red(), color.green(), color.blue(), 100), 6));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawPath(path);
+
+        // 绘制无人机主体
+        painter.setPen(QPen(color, 2));
+        painter.setBrush(QBrush(color));
+        painter.drawPath(path);
+
+        // 绘制内部高光
+        painter.setPen(QPen(QColor(255, 255, 255, 150), 1));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawPath(path);
+    }
+    painter.setOpacity(1.0);
+
+    // 绘制详细信息（包含ID，去掉白色ID）
+    if (scene.showInfo) {
+        drawDroneLabels(painter, scene);
+    }
+}
+
+void RadarSceneRenderer::drawLaserLock(QPainter& painter, const RadarScene& scene)
+{
+    if (scene.laserTargetIndex < 0 || scene.laserTargetIndex >= scene.drones.size()) {
+        return;
+    }
+    QPointF screenPos = toScreen(scene.drones[scene.laserTargetIndex].position);
+
+    // 绘制闪烁的锁定圆圈
+    double blinkPhase = (scene.time % 1000) / 1000.0; // 1秒周期
+    int alpha = (int)(128 + 127 * qSin(blinkPhase * 2 * M_PI)); // 闪烁透明度
+
+    painter.setPen(QPen(QColor(255, 255, 255, alpha), 3)); // 白色闪烁圆圈
+    painter.setBrush(Qt::NoBrush);
+    painter.drawEllipse(screenPos, 15, 15); // 锁定圆圈
+
+    // 绘制锁定十字线
+    painter.setPen(QPen(QColor(255, 255, 255, alpha), 2)); // 白色十字线
+    painter.drawLine(screenPos - QPointF(20, 0), screenPos + QPointF(20, 0));
+    painter.drawLine(screenPos - QPointF(0, 20), screenPos + QPointF(0, 20));
+}
+
+void RadarSceneRenderer::drawHeatmap(QPainter& painter, const RadarScene& scene)
+{
+    if (scene.heatmap.isNull()) {
+        return;
+    }
+
+    // 每格一个像素的小图，平滑缩放到雷达范围上，整层只有一次贴图
+    double screenRadius = scene.radarRadius * m_scaleFactor;
+    painter.save();
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawImage(QRectF(-screenRadius, -screenRadius, 2*screenRadius, 2*screenRadius), scene.heatmap);
+    painter.restore();
+}
+
+void RadarSceneRenderer::drawDroneSprites(QPainter& painter, const RadarScene& scene)
+{
+    for (auto it = m_droneSpriteBatches.begin(); it != m_droneSpriteBatches.end(); ++it) {
+        it.value().clear();
+    }
+    for (const RenderDrone& drone : scene.drones) {
+        m_droneSpriteBatches[drone.color].append(toScreen(drone.position));
+    }
+
+    painter.setBrush(Qt::NoBrush);
+    for (auto it = m_droneSpriteBatches.constBegin(); it != m_droneSpriteBatches.constEnd(); ++it) {
+        if (it.value().isEmpty()) {
+            continue;
+        }
+        painter.setPen(QPen(QColor::fromRgb(it.key()), 6, Qt::SolidLine, Qt::RoundCap));
+        painter.drawPoints(it.value().constData(), it.value().size());
+    }
+}
+
+void RadarSceneRenderer::drawDroneLabels(QPainter& painter, const RadarScene& scene)
+{
+    // 先统一绘制ID号 - 白色加大加粗，只设置一次字体
+    painter.setPen(Qt::white);
+    QFont idFont = painter.font();
+    idFont.setPointSize(12);  // 较大字体
+    idFont.setBold(true);     // 加粗
+    painter.setFont(idFont);
+    for (const RenderDrone& drone : scene.drones) {
+        QPointF textPos = toScreen(drone.position) + QPointF(15, 15);
+        painter.drawText(textPos, QString::number(drone.id));  // 去掉"ID:"
+    }
+
+    // 再绘制速度和距离 - 与三角形同色，字体更大
+    QFont infoFont = painter.font();
+    infoFont.setPointSize(10);   // 增大字体
+    infoFont.setBold(false);     // 不加粗
+    painter.setFont(infoFont);
+
+    QRgb currentColor = 0;
+    bool penSet = false;
+    for (const RenderDrone& drone : scene.drones) {
+        if (!penSet || drone.color != currentColor) {
+            painter.setPen(QColor::fromRgb(drone.color));  // 使用与三角形相同的颜色
+            currentColor = drone.color;
+            penSet = true;
+        }
+
+        QPointF textPos = toScreen(drone.position) + QPointF(15, 15);
+        painter.drawText(textPos + QPointF(0, 16), QString("%1m/s").arg(drone.speed, 0, 'f', 1));     // 速度在第二行
+        painter.drawText(textPos + QPointF(0, 28), QString("%1m").arg(drone.distance, 0, 'f', 0));  // 距离在第三行
+    }
+}
+
+void RadarSceneRenderer::drawTrails(QPainter& painter, const RadarScene& scene)
+{
+    // 轨迹透明度量化为若干档，同一颜色同一档的线段一次drawLines绘制
+    const int alphaBuckets = 8;
+    const qint64 currentTime = scene.time;
+
+    for (auto it = m_trailLineBatches.begin(); it != m_trailLineBatches.end(); ++it) {
+        it.value().clear();
+    }
+    for (auto it = m_trailPointBatches.begin(); it != m_trailPointBatches.end(); ++it) {
+        it.value().clear();
+    }
+    for (auto it = m_trailLinkBatches.begin(); it != m_trailLinkBatches.end(); ++it) {
+        it.value().clear();
+    }
+
+    for (const RenderDrone& drone : scene.drones) {
+        if (drone.trailCount == 0) {
+            continue;
+        }
+
+        const TrailPoint* points = scene.trailPoints.constData() + drone.trailBegin;
+        const int count = drone.trailCount;
+        const quint64 colorKey = quint64(drone.color) << 8;
+
+        // 按轨迹点年龄淡出
+        for (int i = 1; i < count; ++i) {
+            const TrailPoint& point = points[i];
+            double alpha = 1.0 - double(currentTime - point.time) / qMax(1, scene.trailFadeMs);
+            if (alpha <= 0.0) {
+                continue;
+            }
+            int bucket = qBound(0, int(alpha * alphaBuckets), alphaBuckets - 1);
+            quint64 key = colorKey | quint64(bucket);
+
+            QPointF p1 = toScreen(points[i - 1].position);
+            QPointF p2 = toScreen(point.position);
+            m_trailLineBatches[key].append(QLineF(p1, p2));
+
+            // 每3个点画一个小圆点
+            if (i % 3 == 0) {
+                m_trailPointBatches[key].append(p1);
+            }
+        }
+
+        // 连接最后一个轨迹点到当前位置（最亮）
+        m_trailLinkBatches[drone.color].append(
+            QLineF(toScreen(points[count - 1].position), toScreen(drone.position)));
+    }
+
+    auto bucketColor = [alphaBuckets](quint64 key) {
+        QColor color = QColor::fromRgb(QRgb(key >> 8));
+        int bucket = int(key & 0xff);
+        color.setAlpha(int(255 * 0.8 * (bucket + 1) / alphaBuckets)); // 最大透明度为80%
+        return color;
+    };
+
+    painter.setBrush(Qt::NoBrush);
+    for (auto it = m_trailLineBatches.constBegin(); it != m_trailLineBatches.constEnd(); ++it) {
+        if (it.value().isEmpty()) {
+            continue;
+        }
+        // 使用更平滑的线条样式
+        painter.setPen(QPen(bucketColor(it.key()), 3, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+        painter.drawLines(it.value().constData(), it.value().size());
+    }
+    for (auto it = m_trailPointBatches.constBegin(); it != m_trailPointBatches.constEnd(); ++it) {
+        if (it.value().isEmpty()) {
+            continue;
+        }
+        painter.setPen(QPen(bucketColor(it.key()), 4, Qt::SolidLine, Qt::RoundCap));
+        painter.drawPoints(it.value().constData(), it.value().size());
+    }
+    for (auto it = m_trailLinkBatches.constBegin(); it != m_trailLinkBatches.constEnd(); ++it) {
+        if (it.value().isEmpty()) {
+            continue;
+        }
+        QColor linkColor = QColor::fromRgb(it.key());
+        linkColor.setAlpha(220); // 更亮的连接线
+        painter.setPen(QPen(linkColor, 4, Qt::DotLine)); // 增加线条粗细
+        painter.drawLines(it.value().constData(), it.value().size());
+    }
+}
+
+void RadarSceneRenderer::drawStrikeHighlight(QPainter& painter, const RadarScene& scene)
+{
+    // 设置画笔和笔刷为打击高亮效果
+    QPen pen(QColor(255, 0, 0, 200), 4); // 红色，半透明，粗线条
+    pen.setStyle(Qt::DashLine);
+    painter.setPen(pen);
+
+    QBrush brush(QColor(255, 0, 0, 50)); // 红色填充，更透明
+    painter.setBrush(brush);
+
+    // 转换打击中心到屏幕坐标
+    QPointF centerScreen = toScreen(scene.strikeCenter);
+
+    // 将世界坐标的半径转换为屏幕坐标的半径
+    double radiusScreen = scene.strikeRadius * m_scaleFactor;
+
+    // 绘制打击区域圆圈
+    painter.drawEllipse(centerScreen, radiusScreen, radiusScreen);
+
+    // 在中心绘制一个小十字标记
+    painter.setPen(QPen(QColor(255, 255, 0, 255), 2)); // 黄色十字
+    double crossSize = 10;
+    painter.drawLine(centerScreen.x() - crossSize, centerScreen.y(),
+                    centerScreen.x() + crossSize, centerScreen.y());
+    painter.drawLine(centerScreen.x(), centerScreen.y() - crossSize,
+                    centerScreen.x(), centerScreen.y() + crossSize);
+}
+
+void RadarSceneRenderer::drawStrikeEffects(QPainter& painter, const RadarScene& scene)
+{
+    // 绘制所有活跃的打击效果（已结束的效果不会进入场景）
+    for (const RenderStrikeEffect& effect : scene.strikeEffects) {
+        double progress = effect.progress;
+
+        // 创建脉冲效果
+        double pulseScale = 1.0 + 0.5 * qSin(effect.pulsePhase); // 恢复原来的脉冲幅度
+
+        // 随时间增长的外圈
+        double outerRadius = effect.radius * (1.0 + progress * 2.0) * pulseScale;
+        double innerRadius = effect.radius * pulseScale;
+
+        // 渐变透明度
+        int alpha = static_cast<int>(255 * (1.0 - progress));
+
+        // 绘制外圈（冲击波效果）
+        QPen outerPen(QColor(255, 100, 0, alpha / 2), 4); // 更粗的线条和更高的透明度
+        painter.setPen(outerPen);
+        painter.setBrush(Qt::NoBrush);
+
+        QPointF centerScreen = toScreen(effect.center);
+        double outerRadiusScreen = outerRadius * m_scaleFactor;
+        painter.drawEllipse(centerScreen, outerRadiusScreen, outerRadiusScreen);
+
+        // 绘制内圈（核心爆炸效果）
+        QPen innerPen(QColor(255, 200, 0, alpha), 3); // 更粗的线条
+        painter.setPen(innerPen);
+        QBrush innerBrush(QColor(255, 150, 0, alpha / 3)); // 更明显的填充
+        painter.setBrush(innerBrush);
+
+        double innerRadiusScreen = innerRadius * m_scaleFactor;
+        painter.drawEllipse(centerScreen, innerRadiusScreen, innerRadiusScreen);
+
+        // 绘制火花效果
+        if (progress < 0.5) {
+            painter.setPen(QPen(QColor(255, 255, 100, alpha), 1));
+            for (int i = 0; i < 8; ++i) {
+                double angle = i * M_PI / 4.0 + effect.pulsePhase * 0.1;
+                double sparkLength = innerRadiusScreen * (1.5 + 0.5 * qSin(effect.pulsePhase + i));
+                QPointF sparkEnd = centerScreen + QPointF(
+                    qCos(angle) * sparkLength,
+                    qSin(angle) * sparkLength
+                );
+                painter.drawLine(centerScreen, sparkEnd);
+            }
+        }
+    }
+}
+
+RadarRenderWorker::RadarRenderWorker(QObject *parent)
+    : QObject(parent)
+    , m_lastRenderTimeUs(0)
+{
+}
+
+void RadarRenderWorker::renderScene(const RadarScene& scene)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 后缓冲只在尺寸或像素比变化时重新分配
+    const QSize pixelSize = scene.size * scene.devicePixelRatio;
+    if (m_backImage.size() != pixelSize) {
+        m_backImage = QImage(pixelSize, QImage::Format_ARGB32_Premultiplied);
+    }
+    m_backImage.setDevicePixelRatio(scene.devicePixelRatio);
+    m_backImage.fill(Qt::transparent); // 背景网格由GUI线程的缓存层提供
+
+    QPainter painter(&m_backImage);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(scene.size.width() / 2, scene.size.height() / 2);
+    m_renderer.render(painter, scene);
+    painter.end();
+
+    {
+        QMutexLocker locker(&m_frontMutex);
+        m_frontImage.swap(m_backImage);
+    }
+
+    m_lastRenderTimeUs.store(timer.nsecsElapsed() / 1000, std::memory_order_relaxed);
+    emit frameRendered();
+}
+
+void RadarRenderWorker::presentFrame(QPainter& painter)
+{
+    // 只在贴图期间持锁，渲染线程仅在交换缓冲时竞争
+    QMutexLocker locker(&m_frontMutex);
+    if (!m_frontImage.isNull()) {
+        painter.drawImage(QPointF(0, 0), m_frontImage);
+    }
+}
@@ -1,7 +1,5 @@
 #include "RadarSimulator.h"
 #include <QDebug>
-#include <QDataStream>
-#include <QIODevice>
 #include <QDateTime>
 #include <QtMath>
 #include <QJsonDocument>
@@ -11,28 +9,95 @@
 RadarSimulator::RadarSimulator(DroneManager* droneManager, QObject *parent)
     : QObject(parent)
     , m_droneManager(droneManager)
+    , m_scanning(false)
+    , m_serverRunning(false)
     , m_radarCenter(0, 0)
     , m_radarRadius(800.0)
     , m_scanInterval(1000)
+    , m_scanMode(RadarScanMode::FullScan)
+    , m_sectorCount(12)
 {
-    m_scanTimer = new QTimer(this);
-    m_udpSocket = new QUdpSocket(this);
-    m_configSocket = new QUdpSocket(this);
+    qRegisterMetaType<RadarDetection>("RadarDetection");
+    qRegisterMetaType<QList<RadarDetection>>("QList<RadarDetection>");
     
-    connect(m_scanTimer, &QTimer::timeout, this, &RadarSimulator::performRadarScan);
+    m_configSocket = new QUdpSocket(this);
     connect(m_configSocket, &QUdpSocket::readyRead, this, &RadarSimulator::handleConfigMessage);
+    
+    // 雷达工作者移入独立线程，扫描节拍不再受GUI线程绘制和列表刷新影响
+    m_workerThread = new QThread(this);
+    m_workerThread->setObjectName("RadarWorkerThread");
+    m_worker = new RadarWorker(m_droneManager);
+    m_worker->moveToThread(m_workerThread);
+    
+    connect(m_workerThread, &QThread::started, m_worker, &RadarWorker::initialize);
+    connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &RadarWorker::scanCompleted, this, &RadarSimulator::onWorkerScanCompleted);
+    connect(m_worker, &RadarWorker::sectorScanned, this, &RadarSimulator::sectorScanned);
+    connect(m_worker, &RadarWorker::dataSent, this, &RadarSimulator::dataSent);
+    connect(m_worker, &RadarWorker::serverStateChanged, this, [this](bool bound) {
+        m_serverRunning = bound;
+        emit serverStateChanged(bound);
+    });
+    
+    m_workerThread->start(QThread::HighPriority);
+    syncRadarParameters();
 }
 
 RadarSimulator::~RadarSimulator()
 {
-    stopRadar();
-    stopServer();
+    // 在工作线程中同步停止定时器并关闭套接字，然后结束线程
+    QMetaObject::invokeMethod(m_worker, &RadarWorker::shutdown, Qt::BlockingQueuedConnection);
+    m_workerThread->quit();
+    m_workerThread->wait();
+}
+
+void RadarSimulator::setRadarCenter(QPointF center)
+{
+    m_radarCenter = center;
+    syncRadarParameters();
+}
+
+void RadarSimulator::setRadarRadius(double radius)
+{
+    m_radarRadius = radius;
+    syncRadarParameters();
+}
+
+void RadarSimulator::setScanInterval(int intervalMs)
+{
+    m_scanInterval = intervalMs;
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, intervalMs]() {
+        worker->setScanInterval(intervalMs);
+    }, Qt::QueuedConnection);
+}
+
+void RadarSimulator::setScanMode(RadarScanMode mode, int sectorCount)
+{
+    m_scanMode = mode;
+    m_sectorCount = qBound(1, sectorCount, 360);
+    int sectors = m_sectorCount;
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, mode, sectors]() {
+        worker->setScanMode(mode, sectors);
+    }, Qt::QueuedConnection);
+}
+
+void RadarSimulator::syncRadarParameters()
+{
+    QPointF center = m_radarCenter;
+    double radius = m_radarRadius;
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, center, radius]() {
+        worker->setRadarParameters(center, radius);
+    }, Qt::QueuedConnection);
 }
 
 void RadarSimulator::startRadar()
 {
-    if (!m_scanTimer->isActive()) {
-        m_scanTimer->start(m_scanInterval);
+    if (!m_scanning) {
+        m_scanning = true;
+        int interval = m_scanInterval;
+        QMetaObject::invokeMethod(m_worker, [worker = m_worker, interval]() {
+            worker->startScanning(interval);
+        }, Qt::QueuedConnection);
         qDebug() << "Radar started with scan interval:" << m_scanInterval << "ms";
         qDebug() << "Radar center:" << m_radarCenter << "radius:" << m_radarRadius;
     }
@@ -40,38 +105,29 @@ void RadarSimulator::startRadar()
 
 void RadarSimulator::stopRadar()
 {
-    if (m_scanTimer->isActive()) {
-        m_scanTimer->stop();
+    if (m_scanning) {
+        m_scanning = false;
+        QMetaObject::invokeMethod(m_worker, &RadarWorker::stopScanning, Qt::QueuedConnection);
         qDebug() << "Radar stopped";
     }
 }
 
 void RadarSimulator::startServer(quint16 port)
 {
-    if (m_udpSocket->state() != QAbstractSocket::UnconnectedState) {
-        qWarning() << "UDP socket is already bound";
-        return;
-    }
-    
-    if (m_udpSocket->bind(port)) {
-        qDebug() << "UDP server started on port" << port;
-    } else {
-        qWarning() << "Failed to bind UDP socket to port" << port << ":" << m_udpSocket->errorString();
-    }
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, port]() {
+        worker->bindServer(port);
+    }, Qt::QueuedConnection);
 }
 
 void RadarSimulator::stopServer()
 {
-    if (m_udpSocket->state() != QAbstractSocket::UnconnectedState) {
-        m_clients.clear();
-        m_udpSocket->close();
-        qDebug() << "UDP server stopped";
-    }
+    m_clients.clear();
+    QMetaObject::invokeMethod(m_worker, &RadarWorker::closeServer, Qt::QueuedConnection);
 }
 
 bool RadarSimulator::isServerRunning() const
 {
-    return m_udpSocket->state() == QAbstractSocket::BoundState;
+    return m_serverRunning;
 }
 
 void RadarSimulator::addClient(const QHostAddress& address, quint16 port)
@@ -79,6 +135,9 @@ void RadarSimulator::addClient(const QHostAddress& address, quint16 port)
     QPair<QHostAddress, quint16> client(address, port);
     if (!m_clients.contains(client)) {
         m_clients.append(client);
+        QMetaObject::invokeMethod(m_worker, [worker = m_worker, address, port]() {
+            worker->addClient(address, port);
+        }, Qt::QueuedConnection);
         qDebug() << "Added UDP client:" << address.toString() << ":" << port;
         emit clientAdded(QString("%1:%2").arg(address.toString()).arg(port));
     }
@@ -86,156 +145,21 @@ void RadarSimulator::addClient(const QHostAddress& address, quint16 port)
 
 QList<RadarDetection> RadarSimulator::performScan()
 {
-    QList<RadarDetection> detections;
-    QList<Drone*> activeDrones = m_droneManager->getActiveDrones();
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    
-    qDebug() << "=== RADAR SCAN START ===";
-    qDebug() << "Active drones:" << activeDrones.size();
-    qDebug() << "Radar center:" << m_radarCenter << "radius:" << m_radarRadius;
-    
-    for (Drone* drone : activeDrones) {
-        QPointF dronePos = drone->getCurrentPosition();
-        double distance = calculateDistance(m_radarCenter, dronePos);
-        
-        qDebug() << "Checking drone" << drone->getId() 
-                 << "at position" << dronePos 
-                 << "distance from radar:" << distance;
-        
-        // 检查无人机是否在雷达探测范围内
-        if (drone->isInRadarRange(m_radarCenter, m_radarRadius)) {
-            RadarDetection detection;
-            detection.droneId = drone->getId();
-            detection.position = dronePos;
-            detection.velocity = QPointF(drone->getVelocityX(), drone->getVelocityY());
-            detection.detectionTime = currentTime;
-            detection.distance = distance;
-            detection.azimuth = calculateAzimuth(m_radarCenter, detection.position);
-            
-            // 填充轨迹系统信息
-            detection.trajectoryType = drone->getTrajectoryType();
-            detection.speedType = drone->getSpeedType();
-            detection.currentDirection = drone->getCurrentDirection();
-            detection.currentSpeed = drone->getCurrentSpeed();
-            detection.useNewTrajectory = true; // 新生成的无人机都使用新轨迹系统
-            
-            detections.append(detection);
-            
-            qDebug() << "*** DETECTED drone" << detection.droneId 
-                     << "at position" << detection.position
-                     << "distance" << detection.distance
-                     << "azimuth" << qRadiansToDegrees(detection.azimuth) << "degrees";
-        } else {
-            qDebug() << "Drone" << drone->getId() << "is OUT OF RANGE (distance:" << distance << ")";
-        }
+    // 手动扫描同样基于快照，与雷达线程看到的状态一致
+    DroneSnapshotPtr snapshot = m_droneManager->getSnapshot();
+    if (!snapshot) {
+        return QList<RadarDetection>();
     }
-    
-    qDebug() << "=== RADAR SCAN COMPLETE: " << detections.size() << "detections ===";
-    return detections;
+    return RadarWorker::scanSnapshot(*snapshot, m_radarCenter, m_radarRadius,
+                                     QDateTime::currentMSecsSinceEpoch());
 }
 
-void RadarSimulator::performRadarScan()
+void RadarSimulator::onWorkerScanCompleted(QList<RadarDetection> detections)
 {
-    m_latestDetections = performScan();
-    
-    qDebug() << "Radar scan completed. Detections:" << m_latestDetections.size() 
-             << "Clients:" << m_clients.size();
-    
-    // 发送数据到所有连接的客户端
-    if (!m_latestDetections.isEmpty() && !m_clients.isEmpty()) {
-        QByteArray data = serializeDetections(m_latestDetections);
-        qDebug() << "Sending data to clients. Data size:" << data.size() << "bytes";
-        sendDataToClients(data);
-    } else if (m_clients.isEmpty()) {
-        qDebug() << "No clients connected, not sending data";
-    } else {
-        qDebug() << "No detections, not sending data";
-    }
-    
+    m_latestDetections = detections;
     emit radarScanCompleted(m_latestDetections);
 }
 
-void RadarSimulator::sendDataToClients(const QByteArray& data)
-{
-    qDebug() << "Sending UDP data to" << m_clients.size() << "clients";
-    
-    for (const QPair<QHostAddress, quint16>& client : m_clients) {
-        qDebug() << "Sending to client:" << client.first.toString() << ":" << client.second;
-        qint64 bytesWritten = m_udpSocket->writeDatagram(data, client.first, client.second);
-        if (bytesWritten == -1) {
-            qWarning() << "Failed to send UDP data to" << client.first.toString() << ":" << client.second
-                       << m_udpSocket->errorString();
-        } else {
-            qDebug() << "Successfully sent" << bytesWritten << "bytes to" 
-                     << client.first.toString() << ":" << client.second;
-        }
-    }
-    
-    if (!m_clients.isEmpty()) {
-        emit dataSent(data);
-    }
-}
-
-QByteArray RadarSimulator::serializeDetections(const QList<RadarDetection>& detections)
-{
-    QByteArray data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
-    stream.setVersion(QDataStream::Qt_5_15);
-    
-    // 写入魔术数字和版本
-    stream << quint32(0x52444152); // "RDAR"
-    stream << quint32(1);          // Version
-    
-    // 写入时间戳
-    stream << QDateTime::currentMSecsSinceEpoch();
-    
-    // 写入检测数量
-    stream << quint32(detections.size());
-    
-    // 写入每个检测结果
-    for (const RadarDetection& detection : detections) {
-        stream << detection.droneId;
-        stream << detection.position;
-        stream << detection.velocity;
-        stream << detection.detectionTime;
-        stream << detection.distance;
-        stream << detection.azimuth;
-        
-        // 写入轨迹系统信息
-        stream << quint32(static_cast<uint32_t>(detection.trajectoryType));
-        stream << quint32(static_cast<uint32_t>(detection.speedType));
-        stream << detection.currentDirection;
-        stream << detection.currentSpeed;
-        stream << detection.useNewTrajectory;
-    }
-    
-    return data;
-}
-
-double RadarSimulator::calculateDistance(QPointF pos1, QPointF pos2)
-{
-    double dx = pos2.x() - pos1.x();
-    double dy = pos2.y() - pos1.y();
-    return qSqrt(dx * dx + dy * dy);
-}
-
-double RadarSimulator::calculateAzimuth(QPointF center, QPointF target)
-{
-    double dx = target.x() - center.x();
-    double dy = target.y() - center.y();
-    
-    // 计算相对于正北方向的角度（数学角度系统，0度为东，90度为北）
-    // 转换为雷达角度系统（0度为北，顺时针增加）
-    double angle = qAtan2(dx, -dy); // 注意y轴方向
-    
-    // 确保角度在0-2π范围内
-    if (angle < 0) {
-        angle += 2 * M_PI;
-    }
-    
-    return angle;
-}
-
 void RadarSimulator::startConfigServer(quint16 configPort)
 {
     if (m_configSocket->state() != QAbstractSocket::UnconnectedState) {
@@ -290,11 +214,7 @@ void RadarSimulator::processConfigCommand(const QJsonObject& command, const QHos
             if (command.contains("scanInterval")) {
                 int newInterval = command["scanInterval"].toInt();
                 if (newInterval != m_scanInterval) {
-                    m_scanInterval = newInterval;
-                    if (m_scanTimer->isActive()) {
-                        m_scanTimer->stop();
-                        m_scanTimer->start(m_scanInterval);
-                    }
+                    setScanInterval(newInterval);
                     changes += QString("扫描间隔: %1ms ").arg(newInterval);
                     changed = true;
                 }
@@ -303,7 +223,7 @@ void RadarSimulator::processConfigCommand(const QJsonObject& command, const QHos
             if (command.contains("radarRadius")) {
                 double newRadius = command["radarRadius"].toDouble();
                 if (newRadius != m_radarRadius) {
-                    m_radarRadius = newRadius;
+                    setRadarRadius(newRadius);
                     changes += QString("雷达半径: %1px ").arg(newRadius);
                     changed = true;
                 }
@@ -314,12 +234,28 @@ void RadarSimulator::processConfigCommand(const QJsonObject& command, const QHos
                 double newY = command["centerY"].toDouble();
                 QPointF newCenter(newX, newY);
                 if (newCenter != m_radarCenter) {
-                    m_radarCenter = newCenter;
+                    setRadarCenter(newCenter);
                     changes += QString("中心位置: (%1,%2) ").arg(newX).arg(newY);
                     changed = true;
                 }
             }
             
+            if (command.contains("scanMode") || command.contains("sectorCount")) {
+                RadarScanMode newMode = m_scanMode;
+                if (command.contains("scanMode")) {
+                    newMode = (command["scanMode"].toString() == "sector") ? RadarScanMode::SectorScan
+                                                                           : RadarScanMode::FullScan;
+                }
+                int newSectors = command.contains("sectorCount") ? command["sectorCount"].toInt() : m_sectorCount;
+                if (newMode != m_scanMode || newSectors != m_sectorCount) {
+                    setScanMode(newMode, newSectors);
+                    changes += QString("扫描模式: %1/%2扇区 ")
+                                   .arg(newMode == RadarScanMode::SectorScan ? "扇区" : "全向")
+                                   .arg(m_sectorCount);
+                    changed = true;
+                }
+            }
+            
             response["success"] = changed;
             response["message"] = changed ? changes.trimmed() : "没有参数需要更新";
             
@@ -372,6 +308,8 @@ void RadarSimulator::processConfigCommand(const QJsonObject& command, const QHos
             response["radarRadius"] = m_radarRadius;
             response["centerX"] = m_radarCenter.x();
             response["centerY"] = m_radarCenter.y();
+            response["scanMode"] = (m_scanMode == RadarScanMode::SectorScan) ? "sector" : "full";
+            response["sectorCount"] = m_sectorCount;
             response["generationInterval"] = m_droneManager ? m_droneManager->getGenerationInterval() : 3000;
             response["maxDrones"] = 10; // 硬编码值，需要从DroneManager获取
             response["minSpeed"] = 10.0;
@@ -389,6 +327,8 @@ QJsonObject RadarSimulator::getCurrentSettings() const
     settings["radarRadius"] = m_radarRadius;
     settings["centerX"] = m_radarCenter.x();
     settings["centerY"] = m_radarCenter.y();
+    settings["scanMode"] = (m_scanMode == RadarScanMode::SectorScan) ? "sector" : "full";
+    settings["sectorCount"] = m_sectorCount;
     settings["generationInterval"] = m_droneManager ? m_droneManager->getGenerationInterval() : 3000;
     return settings;
 }
@@ -0,0 +1,433 @@
+#include "RadarWorker.h"
+#include "MetricsRegistry.h"
+#include "Tracing.h"
+#include <QDebug>
+#include <QDataStream>
+#include <QIODevice>
+#include <QDateTime>
+#include <QtMath>
+#include <QSet>
+#include <QElapsedTimer>
+
+RadarWorker::RadarWorker(DroneManager* droneManager, QObject *parent)
+    : QObject(parent)
+    , m_droneManager(droneManager)
+    , m_scanTimer(nullptr)
+    , m_udpSocket(nullptr)
+    , m_scanDuration(MetricsRegistry::instance().timer("radar_scan_duration_seconds",
+                                                       "Radar scan time including serialization and send"))
+    , m_radarCenter(0, 0)
+    , m_radarRadius(800.0)
+    , m_scanInterval(1000)
+    , m_scanMode(RadarScanMode::FullScan)
+    , m_sectorCount(12)
+    , m_currentSector(0)
+    , m_indexedSequence(0)
+{
+    // 定时器和套接字在initialize()中创建，保证它们属于工作线程
+}
+
+RadarWorker::~RadarWorker()
+{
+    shutdown();
+}
+
+void RadarWorker::initialize()
+{
+    if (m_scanTimer) {
+        return;
+    }
+
+    m_scanTimer = new QTimer(this);
+    m_scanTimer->setTimerType(Qt::PreciseTimer); // 精确定时，保证扫描节拍稳定
+    m_udpSocket = new QUdpSocket(this);
+
+    connect(m_scanTimer, &QTimer::timeout, this, &RadarWorker::performRadarScan);
+}
+
+void RadarWorker::shutdown()
+{
+    if (m_scanTimer) {
+        m_scanTimer->stop();
+    }
+    closeServer();
+}
+
+void RadarWorker::startScanning(int intervalMs)
+{
+    initialize();
+    m_scanInterval = intervalMs;
+    m_scanTimer->start(m_scanInterval);
+    qDebug() << "Radar worker scanning with interval:" << m_scanInterval << "ms";
+}
+
+void RadarWorker::stopScanning()
+{
+    if (m_scanTimer && m_scanTimer->isActive()) {
+        m_scanTimer->stop();
+    }
+}
+
+void RadarWorker::setScanInterval(int intervalMs)
+{
+    m_scanInterval = intervalMs;
+    if (m_scanTimer && m_scanTimer->isActive()) {
+        m_scanTimer->start(m_scanInterval);
+    }
+    m_azimuthBuckets.clear(); // 一圈的时长变了，按新的时长重新划分快速目标
+}
+
+void RadarWorker::setRadarParameters(QPointF center, double radius)
+{
+    m_radarCenter = center;
+    m_radarRadius = radius;
+    m_azimuthBuckets.clear(); // 方位角以雷达中心为基准，需要重建
+}
+
+void RadarWorker::setScanMode(RadarScanMode mode, int sectorCount)
+{
+    m_scanMode = mode;
+    m_sectorCount = qBound(1, sectorCount, 360);
+    m_currentSector = 0;
+    m_azimuthBuckets.clear();
+    m_sectorPictures.clear();
+    qDebug() << "Radar scan mode:" << (mode == RadarScanMode::SectorScan ? "sector" : "full")
+             << "sectors:" << m_sectorCount;
+}
+
+void RadarWorker::bindServer(quint16 port)
+{
+    initialize();
+    if (m_udpSocket->state() != QAbstractSocket::UnconnectedState) {
+        qWarning() << "UDP socket is already bound";
+        return;
+    }
+
+    if (m_udpSocket->bind(port)) {
+        qDebug() << "UDP server started on port" << port;
+        emit serverStateChanged(true);
+    } else {
+        qWarning() << "Failed to bind UDP socket to port" << port << ":" << m_udpSocket->errorString();
+        emit serverStateChanged(false);
+    }
+}
+
+void RadarWorker::closeServer()
+{
+    if (m_udpSocket && m_udpSocket->state() != QAbstractSocket::UnconnectedState) {
+        m_clients.clear();
+        m_clientMetrics.clear();
+        m_udpSocket->close();
+        qDebug() << "UDP server stopped";
+        emit serverStateChanged(false);
+    }
+}
+
+void RadarWorker::addClient(const QHostAddress& address, quint16 port)
+{
+    QPair<QHostAddress, quint16> client(address, port);
+    if (!m_clients.contains(client)) {
+        m_clients.append(client);
+
+        MetricsRegistry& registry = MetricsRegistry::instance();
+        QString labels = QString("client=\"%1:%2\"").arg(address.toString()).arg(port);
+        ClientMetrics metrics;
+        metrics.datagrams = registry.counter("radar_client_datagrams_sent_total", "Radar datagrams sent per client", labels);
+        metrics.bytes = registry.counter("radar_client_bytes_sent_total", "Radar bytes sent per client", labels);
+        metrics.errors = registry.counter("radar_client_send_errors_total", "Failed radar datagram sends per client", labels);
+        m_clientMetrics.append(metrics);
+    }
+}
+
+bool RadarWorker::detectState(const DroneState& state, QPointF radarCenter, double radarRadius,
+                              qint64 detectionTime, RadarDetection& detection)
+{
+    double dx = state.position.x() - radarCenter.x();
+    double dy = state.position.y() - radarCenter.y();
+    double distanceSquared = dx * dx + dy * dy;
+
+    // 检查无人机是否在雷达探测范围内
+    if (distanceSquared > radarRadius * radarRadius) {
+        return false;
+    }
+
+    detection.droneId = state.id;
+    detection.position = state.position;
+    detection.velocity = state.velocity;
+    detection.detectionTime = detectionTime;
+    detection.distance = qSqrt(distanceSquared);
+
+    // 雷达角度系统（0度为北，顺时针增加）
+    double angle = qAtan2(dx, -dy);
+    if (angle < 0) {
+        angle += 2 * M_PI;
+    }
+    detection.azimuth = angle;
+
+    // 填充轨迹系统信息
+    detection.trajectoryType = state.trajectoryType;
+    detection.speedType = state.speedType;
+    detection.currentDirection = state.currentDirection;
+    detection.currentSpeed = state.currentSpeed;
+    detection.useNewTrajectory = true; // 新生成的无人机都使用新轨迹系统
+    return true;
+}
+
+QList<RadarDetection> RadarWorker::scanSnapshot(const DroneSnapshot& snapshot, QPointF radarCenter,
+                                                double radarRadius, qint64 detectionTime)
+{
+    QList<RadarDetection> detections;
+    RadarDetection detection;
+
+    for (const DroneState& state : snapshot.drones) {
+        if (detectState(state, radarCenter, radarRadius, detectionTime, detection)) {
+            detections.append(detection);
+        }
+    }
+
+    return detections;
+}
+
+void RadarWorker::performRadarScan()
+{
+    RADAR_TRACE_SCOPE("RadarWorker::performRadarScan");
+    DroneSnapshotPtr snapshot = m_droneManager->getSnapshot();
+    if (!snapshot) {
+        return;
+    }
+
+    // 扫描耗时包含序列化和发送
+    QElapsedTimer scanTimer;
+    scanTimer.start();
+    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+    if (m_scanMode == RadarScanMode::SectorScan) {
+        performSectorScan(*snapshot, currentTime);
+        m_scanDuration->record(scanTimer.nsecsElapsed() / 1000);
+        return;
+    }
+
+    QList<RadarDetection> detections = scanSnapshot(*snapshot, m_radarCenter, m_radarRadius, currentTime);
+
+    // 发送数据到所有连接的客户端
+    if (!detections.isEmpty() && !m_clients.isEmpty()) {
+        sendDataToClients(serializeDetections(detections));
+    }
+    m_scanDuration->record(scanTimer.nsecsElapsed() / 1000);
+
+    emit scanCompleted(detections);
+}
+
+int RadarWorker::sectorOf(QPointF position) const
+{
+    double dx = position.x() - m_radarCenter.x();
+    double dy = position.y() - m_radarCenter.y();
+    double angle = qAtan2(dx, -dy);
+    if (angle < 0) {
+        angle += 2 * M_PI;
+    }
+    return qMin(m_sectorCount - 1, int(angle / (2 * M_PI / m_sectorCount)));
+}
+
+void RadarWorker::indexDrone(const DroneState& state)
+{
+    // 一圈内位移为s、距离为d时方位角变化不超过asin(s/d)；速度按两倍计留出加速余量。
+    // 变化不超过一个扇区宽度的目标放进所在扇区的桶，相邻扇区检查即可覆盖，其余每个节拍都检查
+    const double sectorWidth = 2 * M_PI / m_sectorCount;
+    const double rotationSeconds = m_scanInterval * m_sectorCount / 1000.0;
+    double dx = state.position.x() - m_radarCenter.x();
+    double dy = state.position.y() - m_radarCenter.y();
+    double distance = qSqrt(dx * dx + dy * dy);
+    double speed = qMax(qSqrt(QPointF::dotProduct(state.velocity, state.velocity)), state.currentSpeed);
+    double travel = 2.0 * speed * rotationSeconds;
+
+    if (travel >= distance || qAsin(travel / distance) >= sectorWidth) {
+        m_fastMovers.append(state.id);
+    } else {
+        m_azimuthBuckets[sectorOf(state.position)].append(state.id);
+    }
+    m_indexedIds.insert(state.id);
+}
+
+void RadarWorker::rebuildAzimuthIndex(const DroneSnapshot& snapshot)
+{
+    m_azimuthBuckets.resize(m_sectorCount);
+    for (QVector<int>& bucket : m_azimuthBuckets) {
+        bucket.clear();
+    }
+    m_fastMovers.clear();
+    m_indexedIds.clear();
+
+    for (const DroneState& state : snapshot.drones) {
+        indexDrone(state);
+    }
+    m_indexedSequence = snapshot.sequence;
+}
+
+void RadarWorker::indexNewDrones(const DroneSnapshot& snapshot)
+{
+    // 圈中新出现的目标立即入索引，不依赖ID的大小或在快照中的位置；
+    // 每个新快照只做一次集合查找，不重新计算方位角
+    for (const DroneState& state : snapshot.drones) {
+        if (!m_indexedIds.contains(state.id)) {
+            indexDrone(state);
+        }
+    }
+    m_indexedSequence = snapshot.sequence;
+}
+
+void RadarWorker::performSectorScan(const DroneSnapshot& snapshot, qint64 detectionTime)
+{
+    // 每圈开始时重建索引，均摊到每个节拍的代价约为 n/扇区数
+    if (m_currentSector == 0 || m_azimuthBuckets.size() != m_sectorCount) {
+        rebuildAzimuthIndex(snapshot);
+    } else if (snapshot.sequence != m_indexedSequence) {
+        indexNewDrones(snapshot);
+    }
+
+    const double sectorWidth = 2 * M_PI / m_sectorCount;
+    const double beamStart = m_currentSector * sectorWidth;
+    const double beamEnd = beamStart + sectorWidth;
+
+    // 索引建立后目标会继续移动，因此同时检查相邻扇区的桶和快速目标，再按当前实际方位角过滤
+    int candidateSectors[3] = { m_currentSector, -1, -1 };
+    if (m_sectorCount > 1) {
+        candidateSectors[1] = (m_currentSector + m_sectorCount - 1) % m_sectorCount;
+    }
+    if (m_sectorCount > 2) {
+        candidateSectors[2] = (m_currentSector + 1) % m_sectorCount;
+    }
+
+    QList<RadarDetection> detections;
+    RadarDetection detection;
+    auto scanIds = [&](const QVector<int>& droneIds) {
+        for (int droneId : droneIds) {
+            auto index = snapshot.indexById.constFind(droneId);
+            if (index == snapshot.indexById.constEnd()) {
+                continue; // 已被摧毁或移除
+            }
+            const DroneState& state = snapshot.drones[index.value()];
+            if (!detectState(state, m_radarCenter, m_radarRadius, detectionTime, detection)) {
+                continue;
+            }
+            if (detection.azimuth < beamStart || detection.azimuth >= beamEnd) {
+                continue;
+            }
+            detections.append(detection);
+        }
+    };
+    for (int sector : candidateSectors) {
+        if (sector >= 0) {
+            scanIds(m_azimuthBuckets[sector]);
+        }
+    }
+    scanIds(m_fastMovers);
+
+    // 扇区帧即使为空也发送，客户端据此同步波束角度
+    if (!m_clients.isEmpty()) {
+        sendDataToClients(serializeSectorFrame(detections, beamStart, sectorWidth,
+                                               m_currentSector, m_sectorCount));
+    }
+    emit sectorScanned(m_currentSector, beamStart, sectorWidth, detections);
+
+    // 波束扫过的扇区直接替换为本次结果
+    m_sectorPictures.resize(m_sectorCount);
+    m_sectorPictures[m_currentSector] = detections;
+
+    m_currentSector = (m_currentSector + 1) % m_sectorCount;
+    if (m_currentSector == 0) {
+        // 一整圈结束，发布完整态势；跨扇区移动的目标只保留最新一次检测
+        QList<RadarDetection> picture;
+        QSet<int> seen;
+        for (int sector = m_sectorCount - 1; sector >= 0; --sector) {
+            for (const RadarDetection& sectorDetection : m_sectorPictures[sector]) {
+                if (!seen.contains(sectorDetection.droneId)) {
+                    seen.insert(sectorDetection.droneId);
+                    picture.append(sectorDetection);
+                }
+            }
+        }
+        emit scanCompleted(picture);
+    }
+}
+
+void RadarWorker::sendDataToClients(const QByteArray& data)
+{
+    for (int i = 0; i < m_clients.size(); ++i) {
+        const QPair<QHostAddress, quint16>& client = m_clients[i];
+        const ClientMetrics& metrics = m_clientMetrics[i];
+        qint64 bytesWritten = m_udpSocket->writeDatagram(data, client.first, client.second);
+        if (bytesWritten == -1) {
+            metrics.errors->add();
+            qWarning() << "Failed to send UDP data to" << client.first.toString() << ":" << client.second
+                       << m_udpSocket->errorString();
+        } else {
+            metrics.datagrams->add();
+            metrics.bytes->add(quint64(bytesWritten));
+        }
+    }
+
+    if (!m_clients.isEmpty()) {
+        emit dataSent(data);
+    }
+}
+
+static void writeDetections(QDataStream& stream, const QList<RadarDetection>& detections)
+{
+    // 写入检测数量
+    stream << quint32(detections.size());
+
+    // 写入每个检测结果
+    for (const RadarDetection& detection : detections) {
+        stream << detection.droneId;
+        stream << detection.position;
+        stream << detection.velocity;
+        stream << detection.detectionTime;
+        stream << detection.distance;
+        stream << detection.azimuth;
+
+        // 写入轨迹系统信息
+        stream << quint32(static_cast<uint32_t>(detection.trajectoryType));
+        stream << quint32(static_cast<uint32_t>(detection.speedType));
+        stream << detection.currentDirection;
+        stream << detection.currentSpeed;
+        stream << detection.useNewTrajectory;
+    }
+}
+
+QByteArray RadarWorker::serializeDetections(const QList<RadarDetection>& detections)
+{
+    RADAR_TRACE_SCOPE("RadarWorker::serializeDetections");
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    // 写入魔术数字和版本
+    stream << quint32(0x52444152); // "RDAR"
+    stream << quint32(1);          // Version
+
+    // 写入时间戳
+    stream << QDateTime::currentMSecsSinceEpoch();
+
+    writeDetections(stream, detections);
+    return data;
+}
+
+QByteArray RadarWorker::serializeSectorFrame(const QList<RadarDetection>& detections, double beamStart,
+                                             double beamWidth, int sectorIndex, int sectorCount)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    // 版本2：在时间戳之后附带波束信息，检测数据格式与版本1相同
+    stream << quint32(0x52444152); // "RDAR"
+    stream << quint32(2);          // Version
+    stream << QDateTime::currentMSecsSinceEpoch();
+    stream << beamStart;
+    stream << beamWidth;
+    stream << quint32(sectorIndex);
+    stream << quint32(sectorCount);
+
+    writeDetections(stream, detections);
+    return data;
+}
@@ -0,0 +1,104 @@
+#include "RollingCounter.h"
+
+RollingCounter::RollingCounter(qint64 windowMs, int slices)
+    : m_sliceMs(qMax<qint64>(1, windowMs / qMax(1, slices)))
+    , m_slices(qMax(1, slices))
+    , m_newestSlice(-1)
+    , m_count(0)
+    , m_sum(0.0)
+{
+}
+
+void RollingCounter::add(qint64 time, double value)
+{
+    qint64 sliceId = time / m_sliceMs;
+    if (sliceId > m_newestSlice) {
+        advance(time);
+    } else if (sliceId <= m_newestSlice - m_slices.size()) {
+        return; // 早于窗口的迟到数据
+    }
+
+    Slice& slice = m_slices[int(sliceId % m_slices.size())];
+    if (slice.id != sliceId) {
+        slice.id = sliceId;
+        slice.count = 0;
+        slice.sum = 0.0;
+    }
+    ++slice.count;
+    slice.sum += value;
+    ++m_count;
+    m_sum += value;
+
+    // 单调队列：比新值小的旧值不可能再成为最大值（迟到数据不参与，保持队列按时间有序）
+    if (!m_maxQueue.empty() && m_maxQueue.back().sliceId > sliceId) {
+        return;
+    }
+    while (!m_maxQueue.empty() && m_maxQueue.back().value <= value) {
+        m_maxQueue.pop_back();
+    }
+    m_maxQueue.push_back({ sliceId, value });
+}
+
+void RollingCounter::advance(qint64 now)
+{
+    qint64 sliceId = now / m_sliceMs;
+    if (sliceId <= m_newestSlice) {
+        return;
+    }
+    m_newestSlice = sliceId;
+    expireBefore(sliceId - m_slices.size() + 1);
+}
+
+void RollingCounter::expireBefore(qint64 firstValidSlice)
+{
+    // 每个槽位最多检查一次，长时间空闲后的推进也是O(时间片数)
+    for (Slice& slice : m_slices) {
+        if (slice.id >= 0 && slice.id < firstValidSlice) {
+            m_count -= slice.count;
+            m_sum -= slice.sum;
+            slice.id = -1;
+            slice.count = 0;
+            slice.sum = 0.0;
+        }
+    }
+    if (m_count == 0) {
+        m_sum = 0.0; // 消除浮点累计误差
+    }
+
+    while (!m_maxQueue.empty() && m_maxQueue.front().sliceId < firstValidSlice) {
+        m_maxQueue.pop_front();
+    }
+}
+
+void RollingCounter::clear()
+{
+    for (Slice& slice : m_slices) {
+        slice = Slice();
+    }
+    m_newestSlice = -1;
+    m_count = 0;
+    m_sum = 0.0;
+    m_maxQueue.clear();
+}
+
+RollingStats::RollingStats()
+    : m_windows{ RollingCounter(1000, 10),         // 1秒，100毫秒一片
+                 RollingCounter(10 * 1000, 10),    // 10秒，1秒一片
+                 RollingCounter(60 * 1000, 12),    // 1分钟，5秒一片
+                 RollingCounter(600 * 1000, 20) }  // 10分钟，30秒一片
+{
+}
+
+void RollingStats::add(qint64 time, double value)
+{
+    for (RollingCounter& counter : m_windows) {
+        counter.add(time, value);
+    }
+}
+
+void RollingStats::clear()
+{
+    for (RollingCounter& counter : m_windows) {
+        counter.clear();
+    }
+}
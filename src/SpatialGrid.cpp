@@ -0,0 +1,59 @@
+#include "SpatialGrid.h"
+#include <QtMath>
+#include <limits>
+
+SpatialGrid::SpatialGrid(double cellSize)
+    : m_cellSize(qMax(1.0, cellSize))
+    , m_count(0)
+{
+}
+
+void SpatialGrid::setCellSize(double cellSize)
+{
+    // 修改单元大小会使已有分桶失效
+    m_cellSize = qMax(1.0, cellSize);
+    clear();
+}
+
+void SpatialGrid::clear()
+{
+    m_cells.clear();
+    m_count = 0;
+}
+
+void SpatialGrid::insert(int index, QPointF position)
+{
+    Entry entry;
+    entry.index = index;
+    entry.position = position;
+    m_cells[cellKey(cellCoord(position.x()), cellCoord(position.y()))].append(entry);
+    ++m_count;
+}
+
+int SpatialGrid::findNearest(QPointF center, double radius) const
+{
+    int nearestIndex = -1;
+    double nearestDistanceSquared = std::numeric_limits<double>::max();
+
+    forEachInRadius(center, radius, [&](int index, QPointF position) {
+        double dx = position.x() - center.x();
+        double dy = position.y() - center.y();
+        double distanceSquared = dx * dx + dy * dy;
+        if (distanceSquared < nearestDistanceSquared) {
+            nearestDistanceSquared = distanceSquared;
+            nearestIndex = index;
+        }
+    });
+
+    return nearestIndex;
+}
+
+int SpatialGrid::cellCoord(double value) const
+{
+    return int(qFloor(value / m_cellSize));
+}
+
+quint64 SpatialGrid::cellKey(int cellX, int cellY)
+{
+    return (quint64(quint32(cellX)) << 32) | quint64(quint32(cellY));
+}
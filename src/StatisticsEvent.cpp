@@ -0,0 +1,20 @@
+#include "StatisticsEvent.h"
+
+QString StatisticsEvent::details() const
+{
+    switch (type) {
+    case EventType::DroneSpawned:
+        return QStringLiteral("Type: Standard spawned");
+    case EventType::DroneDestroyed:
+        return QStringLiteral("Type: Standard destroyed");
+    case EventType::DroneEscaped:
+        return QStringLiteral("Type: Standard escaped");
+    case EventType::StrikeExecuted:
+        return QString("Destroyed: %1").arg(int(value));
+    case EventType::InterceptExecuted:
+        return QString("Target ID: %1, Threat: %2").arg(droneId).arg(value, 0, 'f', 1);
+    case EventType::HighThreatDetected:
+        return QString("High threat level: %1").arg(value, 0, 'f', 1);
+    }
+    return QString();
+}
@@ -0,0 +1,225 @@
+#include "StatisticsExporter.h"
+#include <QFile>
+#include <QLocale>
+#include <QByteArray>
+#include <QStringList>
+#include <QDebug>
+
+namespace {
+// 缓冲写入：累积到一块再写设备，避免逐行写文件
+class BufferedWriter
+{
+public:
+    explicit BufferedWriter(QIODevice& device, int chunkSize = 64 * 1024)
+        : m_device(device), m_chunkSize(chunkSize), m_ok(true)
+    {
+        m_buffer.reserve(chunkSize + 1024);
+    }
+
+    BufferedWriter& operator<<(const char* text) { m_buffer.append(text); return flushIfFull(); }
+    BufferedWriter& operator<<(char c) { m_buffer.append(c); return flushIfFull(); }
+    BufferedWriter& operator<<(qint64 value) { m_buffer.append(QByteArray::number(value)); return flushIfFull(); }
+    BufferedWriter& operator<<(int value) { m_buffer.append(QByteArray::number(value)); return flushIfFull(); }
+    BufferedWriter& operator<<(double value)
+    {
+        m_buffer.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+        return flushIfFull();
+    }
+
+    // JSON字符串：加引号并转义
+    void appendJsonString(const QString& text)
+    {
+        m_buffer.append('"');
+        const QByteArray utf8 = text.toUtf8();
+        for (char c : utf8) {
+            switch (c) {
+            case '"': m_buffer.append("\\\""); break;
+            case '\\': m_buffer.append("\\\\"); break;
+            case '\n': m_buffer.append("\\n"); break;
+            case '\r': m_buffer.append("\\r"); break;
+            case '\t': m_buffer.append("\\t"); break;
+            default:
+                if (uchar(c) < 0x20) {
+                    m_buffer.append(QByteArray("\\u00") + QByteArray::number(uchar(c), 16).rightJustified(2, '0'));
+                } else {
+                    m_buffer.append(c);
+                }
+            }
+        }
+        m_buffer.append('"');
+        flushIfFull();
+    }
+
+    // CSV字段：加引号，内部引号成对转义
+    void appendCsvQuoted(const QString& text)
+    {
+        m_buffer.append('"');
+        QByteArray utf8 = text.toUtf8();
+        m_buffer.append(utf8.replace('"', "\"\""));
+        m_buffer.append('"');
+        flushIfFull();
+    }
+
+    bool flush()
+    {
+        if (m_ok && !m_buffer.isEmpty()) {
+            m_ok = m_device.write(m_buffer) == m_buffer.size();
+        }
+        m_buffer.clear(); // 保留容量
+        return m_ok;
+    }
+
+    bool isOk() const { return m_ok; }
+
+private:
+    BufferedWriter& flushIfFull()
+    {
+        if (m_buffer.size() >= m_chunkSize) {
+            flush();
+        }
+        return *this;
+    }
+
+    QIODevice& m_device;
+    QByteArray m_buffer;
+    int m_chunkSize;
+    bool m_ok;
+};
+
+// 每处理这么多事件报告一次进度
+const int ProgressInterval = 4096;
+}
+
+StatisticsExporter::StatisticsExporter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+const char* StatisticsExporter::eventTypeName(EventType type)
+{
+    switch (type) {
+    case EventType::DroneSpawned: return "DroneSpawned";
+    case EventType::DroneDestroyed: return "DroneDestroyed";
+    case EventType::DroneEscaped: return "DroneEscaped";
+    case EventType::StrikeExecuted: return "StrikeExecuted";
+    case EventType::InterceptExecuted: return "InterceptExecuted";
+    case EventType::HighThreatDetected: return "HighThreatDetected";
+    }
+    return "Unknown";
+}
+
+bool StatisticsExporter::writeJson(QIODevice& device, const StatisticsExportSnapshot& snapshot,
+                                   const ProgressCallback& progress)
+{
+    BufferedWriter out(device);
+
+    out << "{\n"
+        << "    \"sessionStartTime\": " << snapshot.sessionStartTime << ",\n"
+        << "    \"statistics\": {\n"
+        << "        \"defenseEfficiency\": " << snapshot.defenseEfficiency << ",\n"
+        << "        \"totalDronesDestroyed\": " << snapshot.totalDronesDestroyed << ",\n"
+        << "        \"totalDronesSpawned\": " << snapshot.totalDronesSpawned << ",\n"
+        << "        \"totalInterceptsExecuted\": " << snapshot.totalInterceptsExecuted << ",\n"
+        << "        \"totalStrikesExecuted\": " << snapshot.totalStrikesExecuted << ",\n"
+        << "        \"totalThreatNeutralized\": " << snapshot.totalThreatNeutralized << "\n"
+        << "    },\n"
+        << "    \"events\": [";
+
+    // 每个事件一行，字段及顺序与eventToJson()一致（QJsonObject按键名排序）
+    const int total = snapshot.events.size();
+    int written = 0;
+    snapshot.events.forEach([&](const StatisticsEvent& event) {
+        out << (written == 0 ? "\n        " : ",\n        ");
+        out << "{\"details\": ";
+        out.appendJsonString(event.details());
+        out << ", \"droneId\": " << event.droneId
+            << ", \"positionX\": " << event.position.x()
+            << ", \"positionY\": " << event.position.y()
+            << ", \"timestamp\": " << event.timestamp
+            << ", \"type\": " << static_cast<int>(event.type)
+            << ", \"value\": " << event.value << '}';
+        if (++written % ProgressInterval == 0 && progress) {
+            progress(written, total);
+        }
+    });
+
+    out << "\n    ]\n}\n";
+    if (progress) {
+        progress(written, total);
+    }
+    return out.flush();
+}
+
+bool StatisticsExporter::writeCsv(QIODevice& device, const StatisticsExportSnapshot& snapshot,
+                                  const ProgressCallback& progress)
+{
+    BufferedWriter out(device);
+
+    // CSV 头
+    out << "Timestamp,EventType,DroneID,PositionX,PositionY,Details\n";
+
+    // 数据行：直接追加字段，不经过QString::arg
+    const int total = snapshot.events.size();
+    int written = 0;
+    snapshot.events.forEach([&](const StatisticsEvent& event) {
+        out << event.timestamp << ',' << eventTypeName(event.type) << ',' << event.droneId << ','
+            << event.position.x() << ',' << event.position.y() << ',';
+        out.appendCsvQuoted(event.details());
+        out << '\n';
+        if (++written % ProgressInterval == 0 && progress) {
+            progress(written, total);
+        }
+    });
+
+    if (progress) {
+        progress(written, total);
+    }
+    return out.flush();
+}
+
+void StatisticsExporter::exportFiles(const StatisticsExportSnapshot& snapshot,
+                                     const QString& jsonFilename, const QString& csvFilename)
+{
+    const int fileCount = (jsonFilename.isEmpty() ? 0 : 1) + (csvFilename.isEmpty() ? 0 : 1);
+    if (fileCount == 0) {
+        emit exportFinished(false, "未指定导出文件");
+        return;
+    }
+
+    int filesDone = 0;
+    int lastPercent = -1;
+    auto reportProgress = [this, &filesDone, &lastPercent, fileCount](int written, int total) {
+        double fileFraction = total > 0 ? double(written) / total : 1.0;
+        int percent = int(100.0 * (filesDone + fileFraction) / fileCount);
+        if (percent != lastPercent) {
+            lastPercent = percent;
+            emit exportProgress(percent);
+        }
+    };
+
+    QStringList written;
+    QStringList failed;
+    auto exportOne = [&](const QString& filename, bool json) {
+        if (filename.isEmpty()) {
+            return;
+        }
+        QFile file(filename);
+        bool ok = file.open(json ? QIODevice::WriteOnly : (QIODevice::WriteOnly | QIODevice::Text));
+        if (ok) {
+            ok = json ? writeJson(file, snapshot, reportProgress) : writeCsv(file, snapshot, reportProgress);
+            file.close();
+        }
+        (ok ? written : failed) << filename;
+        ++filesDone;
+    };
+
+    exportOne(jsonFilename, true);
+    exportOne(csvFilename, false);
+
+    if (failed.isEmpty()) {
+        emit exportFinished(true, QString("已导出 %1 个事件到 %2").arg(snapshot.events.size()).arg(written.join(", ")));
+    } else {
+        qDebug() << "Statistics export failed:" << failed;
+        emit exportFinished(false, QString("导出失败: %1").arg(failed.join(", ")));
+    }
+}
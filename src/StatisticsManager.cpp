@@ -1,4 +1,5 @@
 #include "StatisticsManager.h"
+#include "MetricsRegistry.h"
 #include <QDebug>
 #include <QFile>
 #include <QTextStream>
@@ -11,89 +12,294 @@
 
 StatisticsManager::StatisticsManager(QObject *parent)
     : QObject(parent)
+    , m_intake(8192)
+    , m_drainScheduled(false)
+    , m_droppedRecords(0)
+    , m_exportThread(nullptr)
+    , m_exporter(nullptr)
     , m_sessionStartTime(QDateTime::currentMSecsSinceEpoch())
+    , m_responseTimeSum(0.0)
+    , m_responsePairs(0)
+    , m_validResponseTimeSum(0.0)
+    , m_validResponsePairs(0)
+    , m_lifetimeSum(0.0)
 {
     m_updateTimer = new QTimer(this);
     connect(m_updateTimer, &QTimer::timeout, this, &StatisticsManager::updateRealTimeStats);
     m_updateTimer->start(5000); // 每5秒更新一次统计
+
+    m_journal = new EventJournal(this);
+}
+
+StatisticsManager::~StatisticsManager()
+{
+    if (m_exportThread) {
+        m_exportThread->quit();
+        m_exportThread->wait(); // 等待进行中的导出写完
+    }
 }
 
 void StatisticsManager::recordDroneSpawned(int droneId, DroneType type, QPointF position)
 {
-    QString typeStr = "Standard"; // 统一类型
-    StatisticsEvent event(EventType::DroneSpawned, droneId, position, QString("Type: %1 spawned").arg(typeStr));
-    m_events.append(event);
+    Q_UNUSED(type); // 统一类型
+    pushRecord(IntakeRecord::DroneSpawned, droneId, position);
+}
 
-    m_statistics.totalDronesSpawned++;
-    updateStatistics();
+void StatisticsManager::recordDroneDestroyed(int droneId, DroneType type, QPointF position, double threatValue)
+{
+    Q_UNUSED(type);
+    pushRecord(IntakeRecord::DroneDestroyed, droneId, position, threatValue);
+}
 
-    qDebug() << "Statistics: Drone spawned - ID:" << droneId << "Type:" << typeStr;
+void StatisticsManager::recordDroneEscaped(int droneId, DroneType type, QPointF position)
+{
+    Q_UNUSED(type);
+    pushRecord(IntakeRecord::DroneEscaped, droneId, position);
 }
 
-void StatisticsManager::recordDroneDestroyed(int droneId, DroneType type, QPointF position, double threatValue)
+void StatisticsManager::recordStrikeExecuted(QPointF position, double radius, int dronesDestroyed)
 {
-    QString typeStr = "Standard"; // 统一类型
-    StatisticsEvent event(EventType::DroneDestroyed, droneId, position,
-                          QString("Type: %1 destroyed").arg(typeStr));
-    m_events.append(event);
+    Q_UNUSED(radius);
+    pushRecord(IntakeRecord::StrikeExecuted, -1, position, dronesDestroyed);
+}
+
+void StatisticsManager::recordInterceptExecuted(int droneId, QPointF interceptPoint, double threatValue)
+{
+    pushRecord(IntakeRecord::InterceptExecuted, droneId, interceptPoint, threatValue);
+}
 
-    m_statistics.totalDronesDestroyed++;
-    m_statistics.totalThreatNeutralized += threatValue;
+void StatisticsManager::recordHighThreatDetected(int droneId, double threatLevel)
+{
+    pushRecord(IntakeRecord::HighThreatDetected, droneId, QPointF(), threatLevel);
+}
 
-    // 统一类型，不再按类型分类统计
-    // switch (type) 代码已删除，因为现在只有Standard类型
+void StatisticsManager::recordDroneDetected(int droneId)
+{
+    pushRecord(IntakeRecord::DroneDetected, droneId, QPointF());
+}
 
-    updateStatistics();
-    qDebug() << "Statistics: Drone destroyed - ID:" << droneId << "Threat:" << threatValue;
+void StatisticsManager::recordTargetEngaged(int droneId)
+{
+    pushRecord(IntakeRecord::TargetEngaged, droneId, QPointF());
 }
 
-void StatisticsManager::recordDroneEscaped(int droneId, DroneType type, QPointF position)
+void StatisticsManager::recordDisplayLatency(qint64 latencyMs)
 {
-    QString typeStr = "Standard"; // 统一类型
-    StatisticsEvent event(EventType::DroneEscaped, droneId, position,
-                          QString("Type: %1 escaped").arg(typeStr));
-    m_events.append(event);
+    pushRecord(IntakeRecord::DisplayLatency, -1, QPointF(), double(latencyMs));
+}
 
-    m_statistics.totalDronesEscaped++;
-    updateStatistics();
+void StatisticsManager::pushRecord(IntakeRecord::Kind kind, int droneId, QPointF position, double value)
+{
+    // 时间戳在调用线程取得，排队时间不计入统计
+    IntakeRecord record;
+    record.kind = kind;
+    record.droneId = droneId;
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.position = position;
+    record.value = value;
+
+    if (!m_intake.tryPush(record)) {
+        if (QThread::currentThread() != thread()) {
+            m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // 所有者线程上队列已满：先就地汇总腾出空间
+        drainIntake();
+        if (!m_intake.tryPush(record)) {
+            m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
 
-    qDebug() << "Statistics: Drone escaped - ID:" << droneId << "Type:" << typeStr;
+    // 合并通知：上一次排队的汇总尚未执行时不再重复投递
+    if (!m_drainScheduled.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, &StatisticsManager::drainIntake, Qt::QueuedConnection);
+    }
 }
 
-void StatisticsManager::recordStrikeExecuted(QPointF position, double radius, int dronesDestroyed)
+void StatisticsManager::drainIntake()
 {
+    // 先清标志再取数据：之后入队的记录会重新投递一次汇总，不会遗漏
+    m_drainScheduled.store(false, std::memory_order_release);
+
+    IntakeRecord record;
+    int applied = 0;
+    while (m_intake.tryPop(record)) {
+        applyRecord(record);
+        ++applied;
+    }
 
-    m_statistics.totalStrikesExecuted++;
-    updateStatistics();
+    // 整批只重新计算并通知一次
+    if (applied > 0) {
+        updateStatistics();
+    }
+}
+
+void StatisticsManager::applyRecord(const IntakeRecord& record)
+{
+    switch (record.kind) {
+    case IntakeRecord::DroneSpawned: {
+        StatisticsEvent event(record.timestamp, EventType::DroneSpawned, record.droneId, record.position, 0.0);
+        appendEvent(event);
+        touchLifecycle(record.droneId, record.timestamp).spawnTime = record.timestamp;
+        m_statistics.totalDronesSpawned++;
+        break;
+    }
+    case IntakeRecord::DroneDestroyed: {
+        StatisticsEvent event(record.timestamp, EventType::DroneDestroyed, record.droneId, record.position,
+                              record.value);
+        appendEvent(event);
+
+        // 响应时间在摧毁时一次算出并累加，之后生命周期不再需要，直接删除
+        auto it = m_lifecycles.find(record.droneId);
+        if (it != m_lifecycles.end()) {
+            const DroneLifecycle& lifecycle = it.value();
+            if (lifecycle.firstHighThreatTime > 0 && record.timestamp > lifecycle.firstHighThreatTime) {
+                qint64 responseTime = record.timestamp - lifecycle.firstHighThreatTime;
+                m_responseTimeSum += responseTime;
+                m_responsePairs++;
+                if (responseTime < 60000) { // 60秒内有效
+                    m_validResponseTimeSum += responseTime;
+                    m_validResponsePairs++;
+                }
+            }
+            if (lifecycle.spawnTime > 0 && lifecycle.spawnTime <= record.timestamp) {
+                m_lifetimeSum += record.timestamp - lifecycle.spawnTime;
+            }
+            if (lifecycle.engagedTime > 0) {
+                m_latency[int(LatencyMetric::EngagementToKill)].record(record.timestamp - lifecycle.engagedTime);
+            }
+            m_lifecycles.erase(it);
+        }
 
-    qDebug() << "Statistics: Strike executed at" << position << "destroyed" << dronesDestroyed;
+        m_statistics.totalDronesDestroyed++;
+        m_statistics.totalThreatNeutralized += record.value;
+        break;
+    }
+    case IntakeRecord::DroneEscaped: {
+        StatisticsEvent event(record.timestamp, EventType::DroneEscaped, record.droneId, record.position, 0.0);
+        appendEvent(event);
+
+        // 逃脱不产生派生指标，生命周期直接删除
+        m_lifecycles.remove(record.droneId);
+        m_statistics.totalDronesEscaped++;
+        break;
+    }
+    case IntakeRecord::StrikeExecuted:
+        // 打击不进入事件列表，只计入滑动窗口（值为本次摧毁数量）
+        m_rollingByType[int(EventType::StrikeExecuted)].add(record.timestamp, record.value);
+        m_rollingTotal.add(record.timestamp, record.value);
+        m_journal->append(record.timestamp, EventType::StrikeExecuted, -1, record.position, record.value);
+        m_statistics.totalStrikesExecuted++;
+        break;
+    case IntakeRecord::InterceptExecuted: {
+        StatisticsEvent event(record.timestamp, EventType::InterceptExecuted, record.droneId, record.position,
+                              record.value);
+        appendEvent(event);
+        m_statistics.totalInterceptsExecuted++;
+        break;
+    }
+    case IntakeRecord::HighThreatDetected: {
+        StatisticsEvent event(record.timestamp, EventType::HighThreatDetected, record.droneId, QPointF(),
+                              record.value);
+        appendEvent(event);
+
+        DroneLifecycle& lifecycle = touchLifecycle(record.droneId, record.timestamp);
+        if (lifecycle.firstHighThreatTime == 0) {
+            lifecycle.firstHighThreatTime = record.timestamp;
+        }
+        m_statistics.highThreatEvents++;
+        if (record.value > m_statistics.maxThreatLevel) {
+            m_statistics.maxThreatLevel = record.value;
+        }
+        break;
+    }
+    case IntakeRecord::DroneDetected: {
+        // 只记录第一次探测，离开后再次进入不覆盖
+        DroneLifecycle& lifecycle = touchLifecycle(record.droneId, record.timestamp);
+        if (lifecycle.firstDetectionTime != 0) {
+            break;
+        }
+        lifecycle.firstDetectionTime = record.timestamp;
+        if (lifecycle.spawnTime > 0) {
+            m_latency[int(LatencyMetric::TimeToDetection)].record(lifecycle.firstDetectionTime - lifecycle.spawnTime);
+        }
+        break;
+    }
+    case IntakeRecord::TargetEngaged: {
+        // 锁定目标每次刷新威胁列表都会重复上报，只记录第一次
+        DroneLifecycle& lifecycle = touchLifecycle(record.droneId, record.timestamp);
+        if (lifecycle.engagedTime != 0) {
+            break;
+        }
+        lifecycle.engagedTime = record.timestamp;
+        if (lifecycle.firstDetectionTime > 0) {
+            m_latency[int(LatencyMetric::DetectionToEngagement)].record(lifecycle.engagedTime - lifecycle.firstDetectionTime);
+        }
+        break;
+    }
+    case IntakeRecord::DisplayLatency:
+        m_latency[int(LatencyMetric::ScanToDisplay)].record(qint64(record.value));
+        break;
+    }
 }
 
-void StatisticsManager::recordInterceptExecuted(int droneId, QPointF interceptPoint, double threatValue)
+DroneLifecycle& StatisticsManager::touchLifecycle(int droneId, qint64 timestamp)
 {
-    StatisticsEvent event(EventType::InterceptExecuted, droneId, interceptPoint,
-                          QString("Target ID: %1, Threat: %2").arg(droneId));
-    m_events.append(event);
+    DroneLifecycle& lifecycle = m_lifecycles[droneId];
+    lifecycle.lastEventTime = qMax(lifecycle.lastEventTime, timestamp);
+    return lifecycle;
+}
 
-    m_statistics.totalInterceptsExecuted++;
-    updateStatistics();
+void StatisticsManager::pruneLifecycles(qint64 olderThan)
+{
+    for (auto it = m_lifecycles.begin(); it != m_lifecycles.end();) {
+        if (it.value().lastEventTime < olderThan) {
+            it = m_lifecycles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
 
-    qDebug() << "Statistics: Intercept executed for drone" << droneId << "threat:" << threatValue;
+double StatisticsManager::getAverageResponseTime() const
+{
+    return m_responsePairs > 0 ? m_responseTimeSum / m_responsePairs : 0.0;
 }
 
-void StatisticsManager::recordHighThreatDetected(int droneId, double threatLevel)
+double StatisticsManager::getAverageDetectionLatency() const
+{
+    return m_latency[int(LatencyMetric::TimeToDetection)].mean();
+}
+
+void StatisticsManager::appendEvent(const StatisticsEvent& event)
 {
-    StatisticsEvent event(EventType::HighThreatDetected, droneId, QPointF(),
-                          QString("High threat level: %1"));
     m_events.append(event);
+    m_journal->append(event);
+    m_rollingByType[int(event.type)].add(event.timestamp, event.value);
+    m_rollingTotal.add(event.timestamp, event.value);
+}
 
-    m_statistics.highThreatEvents++;
-    if (threatLevel > m_statistics.maxThreatLevel) {
-        m_statistics.maxThreatLevel = threatLevel;
-    }
+StatisticsManager::RollingSnapshot StatisticsManager::snapshotOf(RollingCounter& counter)
+{
+    counter.advance(QDateTime::currentMSecsSinceEpoch());
+
+    RollingSnapshot snapshot;
+    snapshot.count = counter.count();
+    snapshot.sum = counter.sum();
+    snapshot.max = counter.max();
+    snapshot.ratePerSecond = counter.ratePerSecond();
+    return snapshot;
+}
 
-    updateStatistics();
-    qDebug() << "Statistics: High threat detected - Drone" << droneId << "level:" << threatLevel;
+StatisticsManager::RollingSnapshot StatisticsManager::getRollingStats(EventType type, RollingWindow window) const
+{
+    return snapshotOf(m_rollingByType[int(type)].window(window));
+}
+
+StatisticsManager::RollingSnapshot StatisticsManager::getTotalRollingStats(RollingWindow window) const
+{
+    return snapshotOf(m_rollingTotal.window(window));
 }
 
 DefenseStatistics StatisticsManager::getCurrentStatistics() const
@@ -106,24 +312,22 @@ QList<StatisticsEvent> StatisticsManager::getRecentEvents(int minutes) const
     QList<StatisticsEvent> recentEvents;
     qint64 cutoffTime = QDateTime::currentMSecsSinceEpoch() - (minutes * 60 * 1000);
 
-    for (const StatisticsEvent& event : m_events) {
-        if (event.timestamp >= cutoffTime) {
-            recentEvents.append(event);
-        }
-    }
+    m_events.forEachInWindow(cutoffTime, [&recentEvents](const StatisticsEvent& event) {
+        recentEvents.append(event);
+    });
 
     return recentEvents;
 }
 
 QList<StatisticsEvent> StatisticsManager::getEventsByType(EventType type) const
 {
+    // 类型行号索引直接给出匹配的事件，不扫描其他类型
     QList<StatisticsEvent> filteredEvents;
+    filteredEvents.reserve(m_events.countOfType(type));
 
-    for (const StatisticsEvent& event : m_events) {
-        if (event.type == type) {
-            filteredEvents.append(event);
-        }
-    }
+    m_events.forEachOfType(type, [&filteredEvents](const StatisticsEvent& event) {
+        filteredEvents.append(event);
+    });
 
     return filteredEvents;
 }
@@ -191,6 +395,30 @@ QString StatisticsManager::generateReport() const
         double responseTimeSeconds = m_statistics.averageResponseTime / 1000.0;
         stream << QString("平均响应时间: %1 秒\n").arg(responseTimeSeconds, 0, 'f', 2);
     }
+    if (!m_latency[int(LatencyMetric::TimeToDetection)].isEmpty()) {
+        stream << QString("平均探测延迟: %1 秒 (生成到首次探测)\n").arg(getAverageDetectionLatency() / 1000.0, 0, 'f', 2);
+    }
+    stream << "\n";
+
+    // 延迟分布：关注尾部延迟而不只是平均值
+    static const char* const latencyNames[LatencyMetricCount] = {
+        "生成->首次探测", "探测->锁定", "锁定->摧毁", "扫描->显示"
+    };
+    stream << "=== 延迟分布 (毫秒) ===\n";
+    for (int i = 0; i < LatencyMetricCount; ++i) {
+        const LatencyHistogram& histogram = m_latency[i];
+        if (histogram.isEmpty()) {
+            stream << QString("%1: 无数据\n").arg(latencyNames[i]);
+            continue;
+        }
+        stream << QString("%1: p50=%2 p90=%3 p99=%4 max=%5 (样本%6)\n")
+                      .arg(latencyNames[i])
+                      .arg(histogram.p50())
+                      .arg(histogram.p90())
+                      .arg(histogram.p99())
+                      .arg(histogram.max())
+                      .arg(histogram.count());
+    }
     stream << "\n";
 
     // 最近事件摘要
@@ -214,7 +442,7 @@ QString StatisticsManager::generateReport() const
             stream << QString("%1 - %2: %3\n")
                           .arg(eventTime.toString("hh:mm:ss"))
                           .arg(eventTypeStr)
-                          .arg(event.details);
+                          .arg(event.details());
         }
     }
 
@@ -227,89 +455,94 @@ QString StatisticsManager::generateReport() const
     return report;
 }
 
-bool StatisticsManager::exportToJson(const QString& filename) const
+bool StatisticsManager::openJournal(const QString& filename)
 {
-    QJsonArray eventsArray;
-    for (const StatisticsEvent& event : m_events) {
-        eventsArray.append(eventToJson(event));
+    if (!m_journal->open(filename, m_sessionStartTime)) {
+        return false;
     }
+    qDebug() << "Statistics: journaling events to" << filename;
+    return true;
+}
 
-    QJsonObject statsObj;
-    statsObj["totalDronesSpawned"] = m_statistics.totalDronesSpawned;
-    statsObj["totalDronesDestroyed"] = m_statistics.totalDronesDestroyed;
-    statsObj["defenseEfficiency"] = m_statistics.defenseEfficiency;
-    statsObj["totalStrikesExecuted"] = m_statistics.totalStrikesExecuted;
-    statsObj["totalInterceptsExecuted"] = m_statistics.totalInterceptsExecuted;
-    statsObj["totalThreatNeutralized"] = m_statistics.totalThreatNeutralized;
-
-    QJsonObject rootObj;
-    rootObj["sessionStartTime"] = m_sessionStartTime;
-    rootObj["statistics"] = statsObj;
-    rootObj["events"] = eventsArray;
+void StatisticsManager::closeJournal()
+{
+    m_journal->close();
+}
 
-    QJsonDocument doc(rootObj);
+StatisticsExportSnapshot StatisticsManager::exportSnapshot() const
+{
+    StatisticsExportSnapshot snapshot;
+    snapshot.events = m_events; // 隐式共享，之后GUI线程追加事件只分离最新的桶
+    snapshot.sessionStartTime = m_sessionStartTime;
+    snapshot.totalDronesSpawned = m_statistics.totalDronesSpawned;
+    snapshot.totalDronesDestroyed = m_statistics.totalDronesDestroyed;
+    snapshot.totalStrikesExecuted = m_statistics.totalStrikesExecuted;
+    snapshot.totalInterceptsExecuted = m_statistics.totalInterceptsExecuted;
+    snapshot.totalThreatNeutralized = m_statistics.totalThreatNeutralized;
+    snapshot.defenseEfficiency = m_statistics.defenseEfficiency;
+    return snapshot;
+}
 
+bool StatisticsManager::exportToJson(const QString& filename) const
+{
     QFile file(filename);
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(doc.toJson());
-        return true;
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
     }
-    return false;
+    return StatisticsExporter::writeJson(file, exportSnapshot());
 }
 
 bool StatisticsManager::exportToCsv(const QString& filename) const
 {
     QFile file(filename);
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream stream(&file);
-
-        // CSV 头
-        stream << "Timestamp,EventType,DroneID,PositionX,PositionY,Details\n";
-
-        // 数据行
-        for (const StatisticsEvent& event : m_events) {
-            QString eventTypeStr;
-            switch (event.type) {
-            case EventType::DroneSpawned: eventTypeStr = "DroneSpawned"; break;
-            case EventType::DroneDestroyed: eventTypeStr = "DroneDestroyed"; break;
-            case EventType::DroneEscaped: eventTypeStr = "DroneEscaped"; break;
-            case EventType::StrikeExecuted: eventTypeStr = "StrikeExecuted"; break;
-            case EventType::InterceptExecuted: eventTypeStr = "InterceptExecuted"; break;
-            case EventType::HighThreatDetected: eventTypeStr = "HighThreatDetected"; break;
-            }
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    return StatisticsExporter::writeCsv(file, exportSnapshot());
+}
 
-            stream << QString("%1,%2,%3,%4,%5,\"%7\"\n")
-                          .arg(event.timestamp)
-                          .arg(eventTypeStr)
-                          .arg(event.droneId)
-                          .arg(event.position.x())
-                          .arg(event.position.y())
-                          .arg(event.details);
-        }
-        return true;
+void StatisticsManager::exportDataAsync(const QString& jsonFilename, const QString& csvFilename)
+{
+    drainIntake(); // 快照包含已入队但尚未汇总的记录
+    if (!m_exportThread) {
+        // 导出线程按需创建，多次导出按请求顺序依次执行
+        m_exportThread = new QThread(this);
+        m_exportThread->setObjectName("StatisticsExportThread");
+        m_exporter = new StatisticsExporter();
+        m_exporter->moveToThread(m_exportThread);
+        connect(m_exportThread, &QThread::finished, m_exporter, &QObject::deleteLater);
+        connect(m_exporter, &StatisticsExporter::exportProgress, this, &StatisticsManager::exportProgress);
+        connect(m_exporter, &StatisticsExporter::exportFinished, this, &StatisticsManager::exportFinished);
+        m_exportThread->start();
     }
-    return false;
+
+    QMetaObject::invokeMethod(m_exporter, [exporter = m_exporter, snapshot = exportSnapshot(),
+                                           jsonFilename, csvFilename]() {
+        exporter->exportFiles(snapshot, jsonFilename, csvFilename);
+    }, Qt::QueuedConnection);
 }
 
 double StatisticsManager::calculateCurrentThreatLevel() const
 {
-    QList<StatisticsEvent> recentThreats = getRecentEvents(5); // 最近5分钟
+    qint64 cutoffTime = QDateTime::currentMSecsSinceEpoch() - 5 * 60 * 1000; // 最近5分钟
     double totalThreat = 0.0;
     int threatEvents = 0;
 
-    for (const StatisticsEvent& event : recentThreats) {
+    m_events.forEachInWindow(cutoffTime, [&totalThreat, &threatEvents](const StatisticsEvent& event) {
         if (event.type == EventType::HighThreatDetected) {
             totalThreat += event.value;
             threatEvents++;
         }
-    }
+    });
 
     return threatEvents > 0 ? totalThreat / threatEvents : 0.0;
 }
 
 double StatisticsManager::getDefenseEfficiency() const
 {
-    return m_statistics.defenseEfficiency;
+    // 直接由累计计数得出，不依赖updateStatistics()的重新计算
+    int completedThreats = m_statistics.totalDronesDestroyed + m_statistics.totalDronesEscaped;
+    return completedThreats > 0 ? (double(m_statistics.totalDronesDestroyed) / completedThreats) * 100.0 : 0.0;
 }
 
 QString StatisticsManager::getBestPerformanceMetrics() const
@@ -320,24 +553,8 @@ QString StatisticsManager::getBestPerformanceMetrics() const
     double bestEfficiency = m_statistics.defenseEfficiency;
     // int bestStreak = 0; // 连续成功拦截次数 (暂未实现)
 
-    // 计算平均响应时间（从威胁检测到摧毁的时间）
-    QList<StatisticsEvent> threats = getEventsByType(EventType::HighThreatDetected);
-    QList<StatisticsEvent> destructions = getEventsByType(EventType::DroneDestroyed);
-
-    double totalResponseTime = 0.0;
-    int responsePairs = 0;
-
-    for (const StatisticsEvent& threat : threats) {
-        for (const StatisticsEvent& destruction : destructions) {
-            if (destruction.droneId == threat.droneId && destruction.timestamp > threat.timestamp) {
-                totalResponseTime += (destruction.timestamp - threat.timestamp);
-                responsePairs++;
-                break;
-            }
-        }
-    }
-
-    double avgResponseTime = responsePairs > 0 ? totalResponseTime / (responsePairs * 1000.0) : 0.0; // 转换为秒
+    // 平均响应时间（从首次高威胁到摧毁）由生命周期累计量直接得出
+    double avgResponseTime = getAverageResponseTime() / 1000.0; // 转换为秒
 
     metrics = QString("最佳防御效率: %1%\n平均响应时间: %2秒\n总事件数: %3")
                   .arg(bestEfficiency, 0, 'f', 1)
@@ -349,19 +566,30 @@ QString StatisticsManager::getBestPerformanceMetrics() const
 
 void StatisticsManager::clearOldEvents(int daysOld)
 {
-    qint64 cutoffTime = QDateTime::currentMSecsSinceEpoch() - (daysOld * 24 * 60 * 60 * 1000);
-
-    m_events.erase(
-        std::remove_if(m_events.begin(), m_events.end(),
-                       [cutoffTime](const StatisticsEvent& event) {
-                           return event.timestamp < cutoffTime;
-                       }),
-        m_events.end());
+    qint64 cutoffTime = QDateTime::currentMSecsSinceEpoch() - (qint64(daysOld) * 24 * 60 * 60 * 1000);
+    m_events.removeBefore(cutoffTime);
 }
 
 void StatisticsManager::resetStatistics()
 {
+    // 丢弃重置前入队的记录
+    IntakeRecord discarded;
+    while (m_intake.tryPop(discarded)) {
+    }
     m_events.clear();
+    for (RollingStats& stats : m_rollingByType) {
+        stats.clear();
+    }
+    m_rollingTotal.clear();
+    m_lifecycles.clear();
+    m_responseTimeSum = 0.0;
+    m_responsePairs = 0;
+    m_validResponseTimeSum = 0.0;
+    m_validResponsePairs = 0;
+    m_lifetimeSum = 0.0;
+    for (LatencyHistogram& histogram : m_latency) {
+        histogram.clear();
+    }
     m_statistics = DefenseStatistics();
     m_sessionStartTime = QDateTime::currentMSecsSinceEpoch();
     updateStatistics();
@@ -370,11 +598,13 @@ void StatisticsManager::resetStatistics()
 void StatisticsManager::updateRealTimeStats()
 {
     updateStatistics();
+    publishLatencyMetrics(); // 百分位需要扫描桶数组，随定时器低频发布
+    pruneLifecycles(QDateTime::currentMSecsSinceEpoch() - LifecycleRetentionMs);
 
-    // 检查高活动度
-    QList<StatisticsEvent> recentEvents = getRecentEvents(1); // 最近1分钟
-    if (recentEvents.size() > 10) { // 每分钟超过10个事件认为是高活动度
-        emit highActivityDetected(recentEvents.size());
+    // 检查高活动度：读取预先聚合的1分钟窗口计数
+    int recentEventCount = int(getTotalRollingStats(RollingWindow::OneMinute).count);
+    if (recentEventCount > 10) { // 每分钟超过10个事件认为是高活动度
+        emit highActivityDetected(recentEventCount);
     }
 }
 
@@ -391,49 +621,80 @@ void StatisticsManager::updateStatistics()
         }
     }
 
-    // 计算平均响应时间 - 修正为更准确的计算
-    QList<StatisticsEvent> threats = getEventsByType(EventType::HighThreatDetected);
-    QList<StatisticsEvent> destructions = getEventsByType(EventType::DroneDestroyed);
+    // 计算平均响应时间：首次高威胁到摧毁（60秒内有效），没有配对时退化为平均生存时间
+    if (m_statistics.highThreatEvents > 0 && m_statistics.totalDronesDestroyed > 0) {
+        if (m_validResponsePairs > 0) {
+            m_statistics.averageResponseTime = m_validResponseTimeSum / m_validResponsePairs; // 毫秒
+        } else {
+            m_statistics.averageResponseTime = m_lifetimeSum / m_statistics.totalDronesDestroyed;
+        }
+    }
 
-    if (!threats.isEmpty() && !destructions.isEmpty()) {
-        double totalResponseTime = 0.0;
-        int validPairs = 0;
+    publishMetrics();
+    emit statisticsUpdated(m_statistics);
+}
 
-        // 对每个高威胁检测事件，找到对应的摧毁事件
-        for (const StatisticsEvent& threat : threats) {
-            for (const StatisticsEvent& destruction : destructions) {
-                if (destruction.droneId == threat.droneId &&
-                    destruction.timestamp > threat.timestamp &&
-                    (destruction.timestamp - threat.timestamp) < 60000) { // 60秒内有效
-                    totalResponseTime += (destruction.timestamp - threat.timestamp);
-                    validPairs++;
-                    break; // 找到对应的摧毁事件后退出内循环
-                }
-            }
-        }
+void StatisticsManager::publishMetrics()
+{
+    // 统计数据推送到指标注册表，指标服务线程只读取原子量，不访问本对象
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    static MetricGauge* const spawned = registry.gauge("radar_drones_spawned", "Drones spawned this session");
+    static MetricGauge* const destroyed = registry.gauge("radar_drones_destroyed", "Drones destroyed this session");
+    static MetricGauge* const escaped = registry.gauge("radar_drones_escaped", "Drones escaped this session");
+    static MetricGauge* const strikes = registry.gauge("radar_strikes_executed", "Area strikes this session");
+    static MetricGauge* const intercepts = registry.gauge("radar_intercepts_executed", "Intercepts this session");
+    static MetricGauge* const neutralized = registry.gauge("radar_threat_neutralized", "Total threat value neutralized");
+    static MetricGauge* const responseTime = registry.gauge("radar_average_response_time_seconds",
+                                                            "Average high-threat to kill time");
+    static MetricGauge* const efficiency = registry.gauge("radar_defense_efficiency_percent",
+                                                          "Destroyed / (destroyed + escaped)");
+    static MetricGauge* const highThreats = registry.gauge("radar_high_threat_events", "High threat detections this session");
+    static MetricGauge* const maxThreat = registry.gauge("radar_max_threat_level", "Highest threat level seen");
+    static MetricGauge* const storedEvents = registry.gauge("radar_statistics_events_stored", "Events held in the event store");
+    static MetricGauge* const droppedRecords = registry.gauge("radar_statistics_intake_dropped",
+                                                              "Records dropped because the intake queue was full");
+
+    spawned->set(m_statistics.totalDronesSpawned);
+    destroyed->set(m_statistics.totalDronesDestroyed);
+    escaped->set(m_statistics.totalDronesEscaped);
+    strikes->set(m_statistics.totalStrikesExecuted);
+    intercepts->set(m_statistics.totalInterceptsExecuted);
+    neutralized->set(m_statistics.totalThreatNeutralized);
+    responseTime->set(m_statistics.averageResponseTime / 1000.0);
+    efficiency->set(m_statistics.defenseEfficiency);
+    highThreats->set(m_statistics.highThreatEvents);
+    maxThreat->set(m_statistics.maxThreatLevel);
+    storedEvents->set(m_events.size());
+    droppedRecords->set(double(getDroppedRecords()));
+}
 
-        if (validPairs > 0) {
-            m_statistics.averageResponseTime = totalResponseTime / validPairs; // 毫秒
-        } else {
-            // 如果没有威胁-摧毁配对，使用简单的平均生存时间
-            double totalLifetime = 0.0;
-            for (const StatisticsEvent& destruction : destructions) {
-                // 找到对应的生成事件
-                QList<StatisticsEvent> spawns = getEventsByType(EventType::DroneSpawned);
-                for (const StatisticsEvent& spawn : spawns) {
-                    if (spawn.droneId == destruction.droneId && spawn.timestamp <= destruction.timestamp) {
-                        totalLifetime += (destruction.timestamp - spawn.timestamp);
-                        break;
-                    }
-                }
-            }
-            if (destructions.size() > 0) {
-                m_statistics.averageResponseTime = totalLifetime / destructions.size();
+void StatisticsManager::publishLatencyMetrics()
+{
+    static const char* const metricLabels[LatencyMetricCount] = {
+        "time_to_detection", "detection_to_engagement", "engagement_to_kill", "scan_to_display"
+    };
+    static const double quantiles[] = { 0.5, 0.9, 0.99 };
+    const int quantileCount = int(sizeof(quantiles) / sizeof(quantiles[0]));
+
+    // 每个延迟种类、每个分位数一个序列，首次调用时注册
+    static QVector<MetricGauge*> gauges;
+    if (gauges.isEmpty()) {
+        MetricsRegistry& registry = MetricsRegistry::instance();
+        for (int i = 0; i < LatencyMetricCount; ++i) {
+            for (int q = 0; q < quantileCount; ++q) {
+                gauges.append(registry.gauge("radar_latency_seconds", "Latency distribution quantiles",
+                                             QString("metric=\"%1\",quantile=\"%2\"")
+                                                 .arg(metricLabels[i]).arg(quantiles[q])));
             }
         }
     }
 
-    emit statisticsUpdated(m_statistics);
+    for (int i = 0; i < LatencyMetricCount; ++i) {
+        for (int q = 0; q < quantileCount; ++q) {
+            qint64 valueMs = m_latency[i].valueAtPercentile(quantiles[q] * 100.0);
+            gauges[i * quantileCount + q]->set(valueMs / 1000.0);
+        }
+    }
 }
 
 QJsonObject StatisticsManager::eventToJson(const StatisticsEvent& event) const
@@ -444,7 +705,8 @@ QJsonObject StatisticsManager::eventToJson(const StatisticsEvent& event) const
     obj["droneId"] = event.droneId;
     obj["positionX"] = event.position.x();
     obj["positionY"] = event.position.y();
-    obj["details"] = event.details;
+    obj["value"] = event.value;
+    obj["details"] = event.details();
     return obj;
 }
 
@@ -452,9 +714,8 @@ StatisticsEvent StatisticsManager::jsonToEvent(const QJsonObject& json) const
 {
     StatisticsEvent event(static_cast<EventType>(json["type"].toInt()),
                           json["droneId"].toInt(),
-                          QPointF(json["positionX"].toDouble(), json["positionY"].toDouble()),
-
-                          json["details"].toString());
+                          QPointF(json["positionX"].toDouble(), json["positionY"].toDouble()));
     event.timestamp = json["timestamp"].toVariant().toLongLong();
+    event.value = json["value"].toDouble(); // details由类型和数值重新生成
     return event;
 }
@@ -0,0 +1,138 @@
+#include "Tracing.h"
+
+#ifdef RADAR_ENABLE_TRACING
+
+#include <QFile>
+#include <QThread>
+#include <QMutexLocker>
+#include <QCoreApplication>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+thread_local TraceBuffer* t_traceBuffer = nullptr;
+
+void appendJsonString(QByteArray& out, const QByteArray& text)
+{
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (uchar(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+}
+
+TraceBuffer::TraceBuffer(int threadIndex, const QString& threadName, int capacity)
+    : m_threadIndex(threadIndex)
+    , m_threadName(threadName)
+    , m_spans(capacity)
+    , m_written(0)
+{
+}
+
+QVector<TraceSpan> TraceBuffer::snapshot() const
+{
+    const quint64 written = m_written.load(std::memory_order_acquire);
+    const quint64 capacity = quint64(m_spans.size());
+    // 缓冲区已经绕回时，最旧的1/8可能正在被覆盖，跳过不读
+    const quint64 keep = written > capacity ? capacity - capacity / 8 : written;
+
+    QVector<TraceSpan> spans;
+    spans.reserve(int(keep));
+    for (quint64 i = written - keep; i < written; ++i) {
+        spans.append(m_spans[int(i % capacity)]);
+    }
+    return spans;
+}
+
+Tracer::Tracer()
+    : m_epoch(std::chrono::steady_clock::now())
+    , m_bufferCapacity(16384)
+{
+}
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+TraceBuffer& Tracer::threadBuffer()
+{
+    if (!t_traceBuffer) {
+        QMutexLocker locker(&m_mutex);
+        int index = int(m_buffers.size()) + 1;
+        QString name = QThread::currentThread()->objectName();
+        if (name.isEmpty()) {
+            QCoreApplication* app = QCoreApplication::instance();
+            name = app && QThread::currentThread() == app->thread()
+                       ? QString("GuiThread") : QString("Thread %1").arg(index);
+        }
+        m_buffers.emplace_back(new TraceBuffer(index, name, m_bufferCapacity));
+        t_traceBuffer = m_buffers.back().get();
+    }
+    return *t_traceBuffer;
+}
+
+bool Tracer::writeChromeTrace(const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to write trace" << filename << ":" << file.errorString();
+        return false;
+    }
+
+    QVector<TraceBuffer*> buffers;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const std::unique_ptr<TraceBuffer>& buffer : m_buffers) {
+            buffers.append(buffer.get());
+        }
+    }
+
+    // 完整事件（ph=X），时间单位为微秒；线程名以元数据事件给出
+    QByteArray out;
+    out.reserve(1 << 20);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&out, &first]() {
+        out += first ? "\n" : ",\n";
+        first = false;
+    };
+
+    for (TraceBuffer* buffer : buffers) {
+        const QByteArray tid = QByteArray::number(buffer->threadIndex());
+        separator();
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+        appendJsonString(out, buffer->threadName().toUtf8());
+        out += "}}";
+
+        const QVector<TraceSpan> spans = buffer->snapshot();
+        for (const TraceSpan& span : spans) {
+            separator();
+            out += "{\"name\":";
+            appendJsonString(out, QByteArray(span.name));
+            out += ",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid;
+            out += ",\"ts\":" + QByteArray::number(span.startNs / 1000.0, 'f', 3);
+            out += ",\"dur\":" + QByteArray::number(span.durationNs / 1000.0, 'f', 3) + '}';
+
+            if (out.size() > (1 << 20)) {
+                file.write(out);
+                out.clear();
+            }
+        }
+    }
+    out += "\n]}\n";
+    file.write(out);
+
+    return file.error() == QFileDevice::NoError;
+}
+
+#endif // RADAR_ENABLE_TRACING
@@ -0,0 +1,186 @@
+#include "TrackerBank.h"
+
+TrackerBank::TrackerBank(double alpha, double beta)
+    : m_alpha(alpha)
+    , m_beta(beta)
+{
+}
+
+void TrackerBank::setGains(double alpha, double beta)
+{
+    m_alpha = qBound(0.0, alpha, 1.0);
+    m_beta = qBound(0.0, beta, 2.0);
+}
+
+int TrackerBank::createTrack(const RadarDetection& detection)
+{
+    int slot = m_ids.size();
+    m_ids.append(detection.droneId);
+    m_x.append(detection.position.x());
+    m_y.append(detection.position.y());
+    m_vx.append(detection.velocity.x());
+    m_vy.append(detection.velocity.y());
+    m_time.append(detection.detectionTime);
+
+    m_measX.append(0.0);
+    m_measY.append(0.0);
+    m_measTime.append(0);
+    m_hasMeasurement.append(0);
+
+    m_slotById.insert(detection.droneId, slot);
+    return slot;
+}
+
+void TrackerBank::update(const QList<RadarDetection>& detections)
+{
+    // 1. 把量测分散到与状态同下标的数组中；新目标直接以量测初始化
+    for (const RadarDetection& detection : detections) {
+        auto it = m_slotById.constFind(detection.droneId);
+        if (it == m_slotById.constEnd()) {
+            createTrack(detection);
+            continue;
+        }
+
+        int slot = it.value();
+        m_measX[slot] = detection.position.x();
+        m_measY[slot] = detection.position.y();
+        m_measTime[slot] = detection.detectionTime;
+        m_hasMeasurement[slot] = 1;
+    }
+
+    // 2. 对全部槽位做一次连续遍历：预测到量测时刻，再按残差修正位置和速度
+    const int count = m_ids.size();
+    const double alpha = m_alpha;
+    const double beta = m_beta;
+    double* x = m_x.data();
+    double* y = m_y.data();
+    double* vx = m_vx.data();
+    double* vy = m_vy.data();
+    qint64* time = m_time.data();
+    const double* measX = m_measX.constData();
+    const double* measY = m_measY.constData();
+    const qint64* measTime = m_measTime.constData();
+    quint8* hasMeasurement = m_hasMeasurement.data();
+
+    for (int i = 0; i < count; ++i) {
+        if (!hasMeasurement[i]) {
+            continue;
+        }
+        hasMeasurement[i] = 0;
+
+        double dt = (measTime[i] - time[i]) / 1000.0;
+        if (dt <= 0.0) {
+            // 同一时刻的重复量测：直接采用量测位置
+            x[i] = measX[i];
+            y[i] = measY[i];
+            continue;
+        }
+
+        double predictedX = x[i] + vx[i] * dt;
+        double predictedY = y[i] + vy[i] * dt;
+        double residualX = measX[i] - predictedX;
+        double residualY = measY[i] - predictedY;
+
+        x[i] = predictedX + alpha * residualX;
+        y[i] = predictedY + alpha * residualY;
+        vx[i] += (beta / dt) * residualX;
+        vy[i] += (beta / dt) * residualY;
+        time[i] = measTime[i];
+    }
+}
+
+QPointF TrackerBank::filteredPosition(int trackId) const
+{
+    int slot = m_slotById.value(trackId, -1);
+    return slot < 0 ? QPointF() : QPointF(m_x[slot], m_y[slot]);
+}
+
+QPointF TrackerBank::filteredVelocity(int trackId) const
+{
+    int slot = m_slotById.value(trackId, -1);
+    return slot < 0 ? QPointF() : QPointF(m_vx[slot], m_vy[slot]);
+}
+
+qint64 TrackerBank::lastMeasurementTime(int trackId) const
+{
+    int slot = m_slotById.value(trackId, -1);
+    return slot < 0 ? 0 : m_time[slot];
+}
+
+QPointF TrackerBank::predictPosition(int trackId, qint64 time) const
+{
+    int slot = m_slotById.value(trackId, -1);
+    if (slot < 0) {
+        return QPointF();
+    }
+
+    double dt = qMax<qint64>(0, time - m_time[slot]) / 1000.0;
+    return QPointF(m_x[slot] + m_vx[slot] * dt, m_y[slot] + m_vy[slot] * dt);
+}
+
+QList<int> TrackerBank::removeStale(qint64 currentTime, qint64 coastTimeoutMs)
+{
+    QList<int> removed;
+    for (int slot = m_ids.size() - 1; slot >= 0; --slot) {
+        if (currentTime - m_time[slot] > coastTimeoutMs) {
+            removed.append(m_ids[slot]);
+            removeSlot(slot);
+        }
+    }
+    return removed;
+}
+
+void TrackerBank::remove(int trackId)
+{
+    int slot = m_slotById.value(trackId, -1);
+    if (slot >= 0) {
+        removeSlot(slot);
+    }
+}
+
+void TrackerBank::removeSlot(int slot)
+{
+    // 交换删除：把最后一个槽位移到被删除的位置，数组保持连续
+    int last = m_ids.size() - 1;
+    m_slotById.remove(m_ids[slot]);
+
+    if (slot != last) {
+        m_ids[slot] = m_ids[last];
+        m_x[slot] = m_x[last];
+        m_y[slot] = m_y[last];
+        m_vx[slot] = m_vx[last];
+        m_vy[slot] = m_vy[last];
+        m_time[slot] = m_time[last];
+        m_measX[slot] = m_measX[last];
+        m_measY[slot] = m_measY[last];
+        m_measTime[slot] = m_measTime[last];
+        m_hasMeasurement[slot] = m_hasMeasurement[last];
+        m_slotById[m_ids[slot]] = slot;
+    }
+
+    m_ids.removeLast();
+    m_x.removeLast();
+    m_y.removeLast();
+    m_vx.removeLast();
+    m_vy.removeLast();
+    m_time.removeLast();
+    m_measX.removeLast();
+    m_measY.removeLast();
+    m_measTime.removeLast();
+    m_hasMeasurement.removeLast();
+}
+
+void TrackerBank::clear()
+{
+    m_ids.clear();
+    m_x.clear();
+    m_y.clear();
+    m_vx.clear();
+    m_vy.clear();
+    m_time.clear();
+    m_measX.clear();
+    m_measY.clear();
+    m_measTime.clear();
+    m_hasMeasurement.clear();
+    m_slotById.clear();
+}
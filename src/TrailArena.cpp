@@ -0,0 +1,86 @@
+#include "TrailArena.h"
+
+TrailArena::TrailArena(int capacity)
+    : m_capacity(qMax(1, capacity))
+{
+}
+
+void TrailArena::setCapacity(int capacity)
+{
+    capacity = qMax(1, capacity);
+    if (capacity == m_capacity) {
+        return;
+    }
+
+    m_capacity = capacity;
+    m_points.resize(m_heads.size() * m_capacity);
+    m_heads.fill(0);
+    m_counts.fill(0);
+}
+
+int TrailArena::allocate()
+{
+    if (!m_freeSlots.isEmpty()) {
+        int slot = m_freeSlots.takeLast();
+        m_heads[slot] = 0;
+        m_counts[slot] = 0;
+        return slot;
+    }
+
+    // 没有空闲槽位时整体扩展一个槽位（QVector按几何级数扩容）
+    int slot = m_heads.size();
+    m_heads.append(0);
+    m_counts.append(0);
+    m_points.resize(m_heads.size() * m_capacity);
+    return slot;
+}
+
+void TrailArena::release(int slot)
+{
+    if (slot < 0 || slot >= m_heads.size()) {
+        return;
+    }
+    m_counts[slot] = 0;
+    m_freeSlots.append(slot);
+}
+
+void TrailArena::releaseAll()
+{
+    // 保留已分配的存储，后续航迹直接复用
+    m_freeSlots.clear();
+    for (int slot = m_heads.size() - 1; slot >= 0; --slot) {
+        m_heads[slot] = 0;
+        m_counts[slot] = 0;
+        m_freeSlots.append(slot);
+    }
+}
+
+void TrailArena::append(int slot, QPointF position, qint64 time)
+{
+    int& count = m_counts[slot];
+    int& head = m_heads[slot];
+
+    int index;
+    if (count < m_capacity) {
+        index = (head + count) % m_capacity;
+        ++count;
+    } else {
+        // 已满：覆盖最老的点
+        index = head;
+        head = (head + 1) % m_capacity;
+    }
+
+    TrailPoint& point = m_points[slot * m_capacity + index];
+    point.position = position;
+    point.time = time;
+}
+
+void TrailArena::expire(int slot, qint64 cutoffTime)
+{
+    int& count = m_counts[slot];
+    int& head = m_heads[slot];
+    while (count > 0 && m_points[slot * m_capacity + head].time < cutoffTime) {
+        head = (head + 1) % m_capacity;
+        --count;
+    }
+}
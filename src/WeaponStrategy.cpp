@@ -1,5 +1,6 @@
 #include "WeaponStrategy.h"
 #include "DroneManager.h"
+#include "Tracing.h"
 #include <QDebug>
 #include <QtMath>
 #include <algorithm>
@@ -109,6 +110,7 @@ QString WeaponStrategy::getStatusText() const
 
 bool WeaponStrategy::executeStrike(QPointF radarCenter, double radarRadius)
 {
+    RADAR_TRACE_SCOPE("WeaponStrategy::executeStrike");
     if (!canFire()) {
         qDebug() << "武器冷却中，无法开火";
         return false;
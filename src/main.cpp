@@ -17,6 +17,9 @@
 #include <QFont>
 #include <QListWidget>
 #include <QSet>
+#include <QDir>
+#include <QStandardPaths>
+#include <QtMath>
 #include <algorithm>
 #include <exception>
 
@@ -25,6 +28,15 @@
 #include "RadarDisplay.h"
 #include "StatisticsManager.h"
 #include "WeaponStrategy.h"
+#include "MetricsServer.h"
+#include "RadarNetwork.h"
+#include "Diagnostics.h"
+#include "Tracing.h"
+
+#ifdef RADAR_ENABLE_TRACING
+#include <QShortcut>
+#include <QKeySequence>
+#endif
 
 class MainWindow : public QWidget
 {
@@ -47,6 +59,19 @@ public:
 
         qDebug() << "初始化统计管理器...";
         m_statisticsManager = new StatisticsManager(this);
+        // 事件日志写在应用数据目录下，每次运行一个文件
+        QString journalDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/journal";
+        QDir().mkpath(journalDir);
+        m_statisticsManager->openJournal(QString("%1/session_%2.evj").arg(journalDir)
+                                             .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")));
+
+        // 本机指标抓取端点：http://127.0.0.1:9464/metrics
+        m_metricsServer = new MetricsServer(this);
+
+        // 多站雷达网络在界面上启用时才创建
+        m_radarNetwork = nullptr;
+        // 服务器在雷达线程中绑定，状态以serverStateChanged为准
+        m_radarServerRunning = false;
 
         qDebug() << "初始化武器策略系统...";
         m_weaponStrategy = new WeaponStrategy(m_droneManager, this);
@@ -85,6 +110,7 @@ public:
         m_radarSimulator->startServer(12345);
         m_radarSimulator->startConfigServer(12347); // 启动配置服务器
         m_radarSimulator->startRadar();
+        m_metricsServer->start(9464);
 
         // 连接显示器到雷达并注册客户端
         qDebug() << "连接雷达显示器...";
@@ -114,6 +140,16 @@ public:
         qDebug() << "主窗口初始化完成!";
     }
 
+    ~MainWindow()
+    {
+        // 子对象按创建顺序析构，DroneManager会先于雷达被删除；
+        // 先停止雷达线程，避免其在退出时读取已销毁的DroneManager
+        delete m_radarSimulator;
+        m_radarSimulator = nullptr;
+        delete m_radarNetwork;
+        m_radarNetwork = nullptr;
+    }
+
 private slots:
     void onStartStopDroneManager();
     void onStartStopRadar();
@@ -126,6 +162,7 @@ private slots:
     void onStrikeRequested(QPointF position, double radius);
     void onDroneClicked(int droneId, QPointF position);
     void onStrikeModeToggled(bool enabled);
+    void onRadarNetworkToggled(bool enabled);
     void onDroneAddedForStats(int droneId);
     void onDroneDestroyedForStats(int droneId);
     void onDroneEscapedForStats(int droneId); // 【新增3】: 添加槽函数声明
@@ -152,9 +189,12 @@ private:
 private:
     DroneManager* m_droneManager;
     RadarSimulator* m_radarSimulator;
+    bool m_radarServerRunning;
     RadarDisplay* m_radarDisplay;
     StatisticsManager* m_statisticsManager;
     WeaponStrategy* m_weaponStrategy;
+    MetricsServer* m_metricsServer;
+    RadarNetwork* m_radarNetwork;
 
     // UI控件
     QPushButton* m_startStopDroneButton;
@@ -162,6 +202,10 @@ private:
     QDoubleSpinBox* m_generationInterval;
     QDoubleSpinBox* m_scanInterval;
     QDoubleSpinBox* m_radarRadius;
+    QCheckBox* m_backgroundRenderToggle;
+    QCheckBox* m_radarNetworkToggle;
+    QLabel* m_radarNetworkStatusLabel;
+    QLabel* m_fusionStatusLabel;
     QLabel* m_strikeStatusLabel;
     QLabel* m_defenseEfficiencyLabel;
     QLabel* m_totalEventsLabel;
@@ -174,6 +218,7 @@ private:
     QPushButton* m_laserThreatButton;
     QPushButton* m_missileThreatButton;
     QPushButton* m_autoFireButton;
+    QPushButton* m_exportDataButton;
 
     // 状态跟踪
     QSet<int> m_dronesInRadar; // 【新增6】: 添加状态跟踪集合
@@ -348,6 +393,46 @@ void MainWindow::onStrikeModeToggled(bool enabled)
     qDebug() << "Strike mode toggled:" << enabled;
 }
 
+void MainWindow::onRadarNetworkToggled(bool enabled)
+{
+    if (!enabled) {
+        if (m_radarNetwork) {
+            m_radarNetwork->stopNetwork();
+            m_radarNetwork->setFusionEnabled(false);
+        }
+        m_radarNetworkStatusLabel->setText("组网状态: 未启用");
+        m_fusionStatusLabel->setText("融合航迹: -");
+        return;
+    }
+
+    if (!m_radarNetwork) {
+        // 三个站点围绕主雷达均匀分布，覆盖范围彼此重叠
+        m_radarNetwork = new RadarNetwork(m_droneManager, this);
+        const double siteRadius = m_radarRadius->value() * 0.75;
+        for (int i = 0; i < 3; ++i) {
+            double angle = qDegreesToRadians(90.0 + i * 120.0);
+            QPointF center(qCos(angle) * siteRadius * 0.8, -qSin(angle) * siteRadius * 0.8);
+            m_radarNetwork->addSite(center, siteRadius, QString("站点%1").arg(i + 1));
+        }
+        connect(m_radarNetwork, &RadarNetwork::networkScanCompleted, this, [this](int siteCount, int totalDetections) {
+            m_radarNetworkStatusLabel->setText(QString("组网状态: %1个站点, 检测%2次")
+                                                   .arg(siteCount).arg(totalDetections));
+        });
+        connect(m_radarNetwork, &RadarNetwork::fusedTracksUpdated, this, [this](const QList<FusedTrack>& tracks) {
+            int multiSite = 0;
+            for (const FusedTrack& track : tracks) {
+                if (track.sourceCount > 1) {
+                    ++multiSite;
+                }
+            }
+            m_fusionStatusLabel->setText(QString("融合航迹: %1条（多站%2条）").arg(tracks.size()).arg(multiSite));
+        });
+    }
+    m_radarNetwork->startNetwork(int(m_scanInterval->value() * 1000));
+    m_radarNetwork->setFusionEnabled(true, 100);
+    m_radarNetworkStatusLabel->setText("组网状态: 启动中");
+}
+
 void MainWindow::onDroneAddedForStats(int droneId)
 {
     Drone* drone = m_droneManager->getDroneById(droneId);
@@ -391,11 +476,13 @@ void MainWindow::onStatisticsUpdated(const DefenseStatistics& stats)
     m_defenseEfficiencyLabel->setText(QString("防御效率: %1%").arg(stats.defenseEfficiency, 0, 'f', 1));
     int totalEvents = stats.totalDronesSpawned + stats.totalStrikesExecuted +
                       stats.totalInterceptsExecuted + stats.highThreatEvents;
-    m_totalEventsLabel->setText(QString("总事件数: %1").arg(totalEvents));
+    int eventsLastMinute = int(m_statisticsManager->getTotalRollingStats(RollingWindow::OneMinute).count);
+    m_totalEventsLabel->setText(QString("总事件数: %1 (近1分钟: %2)").arg(totalEvents).arg(eventsLastMinute));
 }
 
 void MainWindow::onGenerateReport()
 {
+    m_statisticsManager->flushIntake();
     QString report = m_statisticsManager->generateReport();
     QWidget* reportWindow = new QWidget();
     reportWindow->setWindowTitle("防御统计报告");
@@ -417,9 +504,9 @@ void MainWindow::onExportData()
     QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
     QString jsonFilename = QString("defense_stats_%1.json").arg(timestamp);
     QString csvFilename = QString("defense_events_%1.csv").arg(timestamp);
-    bool jsonSuccess = m_statisticsManager->exportToJson(jsonFilename);
-    bool csvSuccess = m_statisticsManager->exportToCsv(csvFilename);
-    // ... (status message can be shown in a label if needed)
+    // 在导出线程中写文件，界面不阻塞；进度和结果通过信号返回
+    m_exportDataButton->setEnabled(false);
+    m_statisticsManager->exportDataAsync(jsonFilename, csvFilename);
 }
 
 void MainWindow::updateDroneCount()
@@ -439,7 +526,7 @@ void MainWindow::updateRadarStatusInfo()
         static int totalDetected = 0;
         if (droneCount > totalDetected) totalDetected = droneCount;
         m_radarDisplay->setStatusInfo(
-            "已连接", droneCount, totalDetected, "刚刚", "系统运行中",
+            m_radarServerRunning ? "已连接" : "雷达服务未启动", droneCount, totalDetected, "刚刚", "系统运行中",
             QString("无人机数量: %1").arg(droneCount), "雷达状态: 运行中"
             );
     } catch (...) { /* ... */ }
@@ -495,7 +582,9 @@ void MainWindow::updateThreatList(const QList<RadarDetection>& detections)
             m_threatListWidget->addItem(item);
         }
         if (!droneThreats.isEmpty()) {
-            m_radarDisplay->setLaserTarget(droneThreats.first().first->getId());
+            int targetId = droneThreats.first().first->getId();
+            m_radarDisplay->setLaserTarget(targetId);
+            m_statisticsManager->recordTargetEngaged(targetId);
         } else {
             m_radarDisplay->clearLaserTarget();
         }
@@ -519,6 +608,7 @@ void MainWindow::onRadarScanCompleted(const QList<RadarDetection>& detections)
     for (int id : currentDroneIds) {
         if (!m_dronesInRadar.contains(id)) {
             addLogMessage(QString("无人机 %1 进入区域。").arg(id), QColor("#4caf50")); // 绿色
+            m_statisticsManager->recordDroneDetected(id);
         }
     }
     m_dronesInRadar = currentDroneIds; // 更新状态以供下次比较
@@ -683,11 +773,32 @@ void MainWindow::setupUI()
     m_startStopRadarButton->setMinimumHeight(40);
     radarLayout->addLayout(scanLayout);
     radarLayout->addLayout(radiusLayout);
+    m_backgroundRenderToggle = new QCheckBox("后台线程渲染动态图层");
+    m_backgroundRenderToggle->setMinimumHeight(30);
+    m_backgroundRenderToggle->setChecked(m_radarDisplay->getBackgroundRendering());
+    radarLayout->addWidget(m_backgroundRenderToggle);
     radarLayout->addWidget(m_startStopRadarButton);
 
+    QGroupBox* networkGroup = new QGroupBox("多站雷达网络");
+    networkGroup->setObjectName("controlGroup");
+    QVBoxLayout* networkLayout = new QVBoxLayout(networkGroup);
+    networkLayout->setSpacing(10);
+    networkLayout->setContentsMargins(15, 20, 15, 15);
+    m_radarNetworkToggle = new QCheckBox("启用三站组网与航迹融合");
+    m_radarNetworkToggle->setMinimumHeight(30);
+    m_radarNetworkStatusLabel = new QLabel("组网状态: 未启用");
+    m_radarNetworkStatusLabel->setObjectName("statusLabel");
+    m_radarNetworkStatusLabel->setWordWrap(true);
+    m_fusionStatusLabel = new QLabel("融合航迹: -");
+    m_fusionStatusLabel->setObjectName("statusLabel");
+    networkLayout->addWidget(m_radarNetworkToggle);
+    networkLayout->addWidget(m_radarNetworkStatusLabel);
+    networkLayout->addWidget(m_fusionStatusLabel);
+
     QVBoxLayout* basicControlLayout = new QVBoxLayout();
     basicControlLayout->addWidget(droneGroup);
     basicControlLayout->addWidget(radarGroup);
+    basicControlLayout->addWidget(networkGroup);
 
     QVBoxLayout* threatPanelLayout = new QVBoxLayout();
 
@@ -757,11 +868,11 @@ void MainWindow::setupUI()
     QPushButton* generateReportButton = new QPushButton("生成报告");
     generateReportButton->setObjectName("secondaryButton");
     generateReportButton->setMinimumHeight(35);
-    QPushButton* exportDataButton = new QPushButton("导出数据");
-    exportDataButton->setObjectName("warningButton");
-    exportDataButton->setMinimumHeight(35);
+    m_exportDataButton = new QPushButton("导出数据");
+    m_exportDataButton->setObjectName("warningButton");
+    m_exportDataButton->setMinimumHeight(35);
     reportButtonLayout->addWidget(generateReportButton);
-    reportButtonLayout->addWidget(exportDataButton);
+    reportButtonLayout->addWidget(m_exportDataButton);
     statisticsLayout->addWidget(m_defenseEfficiencyLabel);
     statisticsLayout->addWidget(m_totalEventsLabel);
     statisticsLayout->addLayout(reportButtonLayout);
@@ -1105,6 +1216,10 @@ void MainWindow::setupConnections()
     connect(m_droneManager, &DroneManager::droneAdded, this, &MainWindow::updateDroneCount);
     connect(m_droneManager, &DroneManager::droneRemoved, this, &MainWindow::updateDroneCount);
     connect(m_radarSimulator, &RadarSimulator::radarScanCompleted, this, &MainWindow::onRadarScanCompleted);
+    connect(m_radarSimulator, &RadarSimulator::serverStateChanged, this, [this](bool running) {
+        m_radarServerRunning = running;
+        updateRadarStatusInfo();
+    });
     connect(m_radarDisplay, &RadarDisplay::connectionStatusChanged, this, [this](bool connected) {
         if (connected) {
             m_radarSimulator->addClient(QHostAddress::LocalHost, 12346);
@@ -1112,12 +1227,44 @@ void MainWindow::setupConnections()
     });
     connect(m_startStopDroneButton, &QPushButton::clicked, this, &MainWindow::onStartStopDroneManager);
     connect(m_startStopRadarButton, &QPushButton::clicked, this, &MainWindow::onStartStopRadar);
+    connect(m_radarNetworkToggle, &QCheckBox::toggled, this, &MainWindow::onRadarNetworkToggled);
+    connect(m_backgroundRenderToggle, &QCheckBox::toggled, m_radarDisplay, &RadarDisplay::setBackgroundRendering);
     connect(m_generationInterval, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &MainWindow::onGenerationIntervalChanged);
     connect(m_droneManager, &DroneManager::highPriorityThreatDetected, this, &MainWindow::onHighPriorityThreatDetected);
     connect(m_droneManager, &DroneManager::strikeExecuted, this, &MainWindow::onStrikeExecutedForStats);
     connect(m_statisticsManager, &StatisticsManager::statisticsUpdated, this, &MainWindow::onStatisticsUpdated);
+    connect(m_exportDataButton, &QPushButton::clicked, this, &MainWindow::onExportData);
+    connect(m_statisticsManager, &StatisticsManager::exportProgress, this, [this](int percent) {
+        m_exportDataButton->setText(QString("导出中 %1%").arg(percent));
+    });
+    connect(m_statisticsManager, &StatisticsManager::exportFinished, this, [this](bool success, const QString& message) {
+        m_exportDataButton->setText("导出数据");
+        m_exportDataButton->setEnabled(true);
+        addLogMessage(message, success ? QColor("#4caf50") : QColor("#f44336"));
+    });
     connect(m_radarDisplay, &RadarDisplay::strikeRequested, this, &MainWindow::onStrikeRequested);
     connect(m_radarDisplay, &RadarDisplay::droneClicked, this, &MainWindow::onDroneClicked);
+    connect(m_metricsServer, &MetricsServer::listeningChanged, this, [this](bool listening, quint16 port) {
+        if (listening) {
+            addLogMessage(QString("指标服务已启动: http://127.0.0.1:%1/metrics").arg(port), QColor("#4caf50"));
+        }
+    });
+#ifdef RADAR_ENABLE_TRACING
+    // Ctrl+Shift+T 导出追踪数据（Chrome Trace Event JSON）
+    QShortcut* traceShortcut = new QShortcut(QKeySequence("Ctrl+Shift+T"), this);
+    connect(traceShortcut, &QShortcut::activated, this, [this]() {
+        QString traceDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/traces";
+        QDir().mkpath(traceDir);
+        QString filename = QString("%1/trace_%2.json").arg(traceDir)
+                               .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+        if (Tracer::instance().writeChromeTrace(filename)) {
+            addLogMessage(QString("追踪数据已导出: %1").arg(filename), QColor("#4caf50"));
+        } else {
+            addLogMessage(QString("追踪数据导出失败: %1").arg(filename), QColor("#f44336"));
+        }
+    });
+#endif
+    connect(m_radarDisplay, &RadarDisplay::radarFrameDisplayed, m_statisticsManager, &StatisticsManager::recordDisplayLatency);
     connect(m_strikeModeToggle, &QCheckBox::toggled, this, [this](bool enabled) {
         m_radarDisplay->setStrikeMode(enabled);
         m_radarDisplay->setStrikeRadius(120.0);
@@ -1162,6 +1309,12 @@ int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
 
+    // 诊断参数（如--self-test）不显示主窗口，执行完直接退出
+    int diagnosticsResult = Diagnostics::run(app.arguments());
+    if (diagnosticsResult >= 0) {
+        return diagnosticsResult;
+    }
+
     MainWindow window;
     window.show();
 